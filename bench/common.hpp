@@ -0,0 +1,98 @@
+#ifndef SQLW_BENCH_COMMON_H_
+#define SQLW_BENCH_COMMON_H_
+
+#include "sqlw/connection.hpp"
+#include "sqlw/statement.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace sqlw_bench
+{
+/**
+ * Where the benchmarked database lives. Passed as the first argument
+ * of every benchmark.
+ */
+enum Storage : int64_t
+{
+    IN_MEMORY = 0,
+    TEMP_FILE = 1,
+};
+
+/**
+ * Opens a fresh database and optionally fills table
+ * `item (id INTEGER PRIMARY KEY, name TEXT, price REAL)` with `rows` rows.
+ */
+class Database
+{
+  public:
+    Database(benchmark::State& state, int64_t rows = 0)
+    {
+        if (TEMP_FILE == state.range(0))
+        {
+            m_path = (std::filesystem::temp_directory_path() /
+                      ("sqlw_bench_" + std::to_string(state.thread_index()) +
+                       ".db"))
+                         .string();
+            std::remove(m_path.data());
+            con.connect(m_path);
+        }
+        else
+        {
+            con.connect(":memory:");
+        }
+
+        sqlite3_exec(
+            con.handle(),
+            "PRAGMA journal_mode=WAL;"
+            "CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, price "
+            "REAL);",
+            nullptr,
+            nullptr,
+            nullptr);
+
+        if (rows > 0)
+        {
+            sqlite3_exec(
+                con.handle(),
+                ("WITH RECURSIVE s(x) AS (SELECT 1 UNION ALL SELECT x + 1 "
+                 "FROM s WHERE x < " +
+                 std::to_string(rows) +
+                 ") INSERT INTO item SELECT x, 'item_' || x, x * 0.25 FROM s")
+                    .data(),
+                nullptr,
+                nullptr,
+                nullptr);
+        }
+    }
+
+    ~Database()
+    {
+        con.close();
+
+        if (!m_path.empty())
+        {
+            std::remove(m_path.data());
+            std::remove((m_path + "-wal").data());
+            std::remove((m_path + "-shm").data());
+        }
+    }
+
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+
+    sqlw::Connection con;
+
+  private:
+    std::string m_path;
+};
+
+inline auto storage_label(benchmark::State& state) -> void
+{
+    state.SetLabel(TEMP_FILE == state.range(0) ? "temp file" : "in memory");
+}
+} // namespace sqlw_bench
+
+#endif // SQLW_BENCH_COMMON_H_
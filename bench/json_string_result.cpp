@@ -0,0 +1,79 @@
+#include "common.hpp"
+#include "sqlw/json_string_result.hpp"
+#include "sqlw/statement.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+// Stays below SQLW_EXEC_LIMIT so that operator() returns every row.
+static constexpr int64_t JSON_ROWS = 200;
+
+static void raw_json_serialization(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, JSON_ROWS};
+    sqlw_bench::storage_label(state);
+
+    for (auto _ : state)
+    {
+        std::string json{"["};
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(
+            db.con.handle(),
+            "SELECT id, name, price FROM item",
+            -1,
+            &stmt,
+            nullptr);
+
+        while (SQLITE_ROW == sqlite3_step(stmt))
+        {
+            json += json.size() > 1 ? ",{" : "{";
+
+            for (int i = 0; i < sqlite3_column_count(stmt); i++)
+            {
+                json += i > 0 ? ",\"" : "\"";
+                json += sqlite3_column_name(stmt, i);
+                json += "\":\"";
+                json += reinterpret_cast<const char*>(
+                    sqlite3_column_text(stmt, i));
+                json += '"';
+            }
+
+            json += '}';
+        }
+
+        json += ']';
+        sqlite3_finalize(stmt);
+        benchmark::DoNotOptimize(json);
+    }
+
+    state.SetItemsProcessed(state.iterations() * JSON_ROWS);
+}
+BENCHMARK(raw_json_serialization)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void sqlw_json_string_result(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, JSON_ROWS};
+    sqlw_bench::storage_label(state);
+
+    for (auto _ : state)
+    {
+        sqlw::JsonStringResult result;
+        sqlw::Statement stmt{&db.con};
+        stmt("SELECT id, name, price FROM item", [&](auto args) {
+            // `id` is the first column of every row.
+            if (0 == args.column_name.compare("id"))
+            {
+                result.row(args.column_count);
+            }
+
+            result.column(args.column_name, args.column_type, args.column_value);
+        });
+        benchmark::DoNotOptimize(result.get_array_result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * JSON_ROWS);
+}
+BENCHMARK(sqlw_json_string_result)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
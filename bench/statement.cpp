@@ -0,0 +1,368 @@
+#include "common.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+
+// Every benchmark comes in a pair: `raw_*` talks to the sqlite3 C API
+// directly, `sqlw_*` does the same work through the wrapper. Comparing the
+// two gives the wrapper's overhead.
+
+static constexpr int64_t LOOKUP_TABLE_ROWS = 100'000;
+
+static void raw_prepare_step_finalize(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+
+    for (auto _ : state)
+    {
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(db.con.handle(), "SELECT 1", -1, &stmt, nullptr);
+        benchmark::DoNotOptimize(sqlite3_step(stmt));
+        benchmark::DoNotOptimize(sqlite3_column_int64(stmt, 0));
+        sqlite3_finalize(stmt);
+    }
+}
+BENCHMARK(raw_prepare_step_finalize)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void sqlw_prepare_step_finalize(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+
+    for (auto _ : state)
+    {
+        sqlw::Statement stmt{&db.con};
+        benchmark::DoNotOptimize(stmt("SELECT 1", [](auto args) {
+            benchmark::DoNotOptimize(args.column_value);
+        }));
+    }
+}
+BENCHMARK(sqlw_prepare_step_finalize)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void raw_point_lookup(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, LOOKUP_TABLE_ROWS};
+    sqlw_bench::storage_label(state);
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> id{1, LOOKUP_TABLE_ROWS};
+
+    for (auto _ : state)
+    {
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(
+            db.con.handle(),
+            "SELECT name FROM item WHERE id = ?1",
+            -1,
+            &stmt,
+            nullptr);
+        sqlite3_bind_int(stmt, 1, id(rng));
+
+        while (SQLITE_ROW == sqlite3_step(stmt))
+        {
+            benchmark::DoNotOptimize(sqlite3_column_text(stmt, 0));
+        }
+
+        sqlite3_finalize(stmt);
+    }
+}
+BENCHMARK(raw_point_lookup)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void raw_point_lookup_reused(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, LOOKUP_TABLE_ROWS};
+    sqlw_bench::storage_label(state);
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> id{1, LOOKUP_TABLE_ROWS};
+
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(
+        db.con.handle(),
+        "SELECT name FROM item WHERE id = ?1",
+        -1,
+        &stmt,
+        nullptr);
+
+    for (auto _ : state)
+    {
+        sqlite3_bind_int(stmt, 1, id(rng));
+
+        while (SQLITE_ROW == sqlite3_step(stmt))
+        {
+            benchmark::DoNotOptimize(sqlite3_column_text(stmt, 0));
+        }
+
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+}
+BENCHMARK(raw_point_lookup_reused)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void sqlw_point_lookup(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, LOOKUP_TABLE_ROWS};
+    sqlw_bench::storage_label(state);
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> id{1, LOOKUP_TABLE_ROWS};
+
+    for (auto _ : state)
+    {
+        sqlw::Statement stmt{&db.con};
+        stmt(
+            "SELECT name FROM item WHERE id = ?1",
+            [](sqlw::Statement::ExecArgs args) {
+                benchmark::DoNotOptimize(args.column_value);
+            },
+            std::tuple{id(rng)});
+    }
+}
+BENCHMARK(sqlw_point_lookup)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void raw_scan(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, state.range(1)};
+    sqlw_bench::storage_label(state);
+
+    for (auto _ : state)
+    {
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(
+            db.con.handle(),
+            "SELECT id, name, price FROM item",
+            -1,
+            &stmt,
+            nullptr);
+
+        while (SQLITE_ROW == sqlite3_step(stmt))
+        {
+            benchmark::DoNotOptimize(sqlite3_column_int64(stmt, 0));
+            benchmark::DoNotOptimize(sqlite3_column_text(stmt, 1));
+            benchmark::DoNotOptimize(sqlite3_column_double(stmt, 2));
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(raw_scan)
+    ->Args({sqlw_bench::IN_MEMORY, 1 << 20})
+    ->Args({sqlw_bench::TEMP_FILE, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+// operator() stops after SQLW_EXEC_LIMIT rows, so large results are
+// stepped with exec() directly.
+static void sqlw_scan(benchmark::State& state)
+{
+    sqlw_bench::Database db{state, state.range(1)};
+    sqlw_bench::storage_label(state);
+
+    const sqlw::Statement::callback_t callback =
+        [](sqlw::Statement::ExecArgs args) {
+            benchmark::DoNotOptimize(args.column_value);
+        };
+
+    for (auto _ : state)
+    {
+        sqlw::Statement stmt{&db.con};
+        stmt.prepare("SELECT id, name, price FROM item");
+
+        while (sqlw::status::Condition::ROW == stmt.exec(callback).status())
+        {
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(sqlw_scan)
+    ->Args({sqlw_bench::IN_MEMORY, 1 << 20})
+    ->Args({sqlw_bench::TEMP_FILE, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+// `sqlw_bulk_insert_span` and `sqlw_bulk_insert_tuple` prepare the
+// statement for every row, like this one.
+static void raw_bulk_insert(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    const int64_t rows = state.range(1);
+
+    for (auto _ : state)
+    {
+        sqlite3_exec(
+            db.con.handle(), "BEGIN; DELETE FROM item", nullptr, nullptr, nullptr);
+
+        for (int i = 0; i < rows; i++)
+        {
+            sqlite3_stmt* stmt;
+            sqlite3_prepare_v2(
+                db.con.handle(),
+                "INSERT INTO item (id, name, price) VALUES (?1, ?2, ?3)",
+                -1,
+                &stmt,
+                nullptr);
+            sqlite3_bind_int(stmt, 1, i);
+            sqlite3_bind_text(stmt, 2, "item", 4, SQLITE_TRANSIENT);
+            sqlite3_bind_double(stmt, 3, i * 0.25);
+            sqlite3_step(stmt);
+            sqlite3_finalize(stmt);
+        }
+
+        sqlite3_exec(db.con.handle(), "COMMIT", nullptr, nullptr, nullptr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(raw_bulk_insert)
+    ->Args({sqlw_bench::IN_MEMORY, 10'000})
+    ->Args({sqlw_bench::TEMP_FILE, 10'000})
+    ->Unit(benchmark::kMillisecond);
+
+static void raw_bulk_insert_reused(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    const int64_t rows = state.range(1);
+
+    for (auto _ : state)
+    {
+        sqlite3_exec(
+            db.con.handle(), "BEGIN; DELETE FROM item", nullptr, nullptr, nullptr);
+
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(
+            db.con.handle(),
+            "INSERT INTO item (id, name, price) VALUES (?1, ?2, ?3)",
+            -1,
+            &stmt,
+            nullptr);
+
+        for (int i = 0; i < rows; i++)
+        {
+            sqlite3_bind_int(stmt, 1, i);
+            sqlite3_bind_text(stmt, 2, "item", 4, SQLITE_TRANSIENT);
+            sqlite3_bind_double(stmt, 3, i * 0.25);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db.con.handle(), "COMMIT", nullptr, nullptr, nullptr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(raw_bulk_insert_reused)
+    ->Args({sqlw_bench::IN_MEMORY, 10'000})
+    ->Args({sqlw_bench::TEMP_FILE, 10'000})
+    ->Unit(benchmark::kMillisecond);
+
+static void sqlw_bulk_insert_reused(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    const int64_t rows = state.range(1);
+
+    for (auto _ : state)
+    {
+        sqlw::Statement{&db.con}("BEGIN; DELETE FROM item");
+
+        sqlw::Statement stmt{&db.con};
+        stmt.prepare("INSERT INTO item (id, name, price) VALUES (?1, ?2, ?3)");
+
+        for (int i = 0; i < rows; i++)
+        {
+            stmt.bind(1, i).bind(2, "item").bind(3, i * 0.25).exec();
+            sqlite3_reset(stmt.handle());
+        }
+
+        sqlw::Statement{&db.con}("COMMIT");
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(sqlw_bulk_insert_reused)
+    ->Args({sqlw_bench::IN_MEMORY, 10'000})
+    ->Args({sqlw_bench::TEMP_FILE, 10'000})
+    ->Unit(benchmark::kMillisecond);
+
+static void sqlw_bulk_insert_span(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    const int64_t rows = state.range(1);
+
+    for (auto _ : state)
+    {
+        sqlw::Statement{&db.con}("BEGIN; DELETE FROM item");
+
+        for (int i = 0; i < rows; i++)
+        {
+            const auto id = std::to_string(i);
+            const auto price = std::to_string(i * 0.25);
+            sqlw::Statement stmt{&db.con};
+            stmt(
+                "INSERT INTO item (id, name, price) VALUES (?1, ?2, ?3)",
+                std::array<sqlw::Statement::bindable_t, 3>{{
+                    {id, sqlw::Type::SQL_INT},
+                    {"item", sqlw::Type::SQL_TEXT},
+                    {price, sqlw::Type::SQL_DOUBLE},
+                }});
+        }
+
+        sqlw::Statement{&db.con}("COMMIT");
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(sqlw_bulk_insert_span)
+    ->Args({sqlw_bench::IN_MEMORY, 10'000})
+    ->Args({sqlw_bench::TEMP_FILE, 10'000})
+    ->Unit(benchmark::kMillisecond);
+
+static void sqlw_bulk_insert_tuple(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    const int64_t rows = state.range(1);
+
+    for (auto _ : state)
+    {
+        sqlw::Statement{&db.con}("BEGIN; DELETE FROM item");
+
+        for (int i = 0; i < rows; i++)
+        {
+            sqlw::Statement stmt{&db.con};
+            stmt(
+                "INSERT INTO item (id, name, price) VALUES (?1, ?2, ?3)",
+                std::tuple{
+                    i,
+                    sqlw::Statement::bindable_t{"item", sqlw::Type::SQL_TEXT},
+                    i * 0.25});
+        }
+
+        sqlw::Statement{&db.con}("COMMIT");
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(sqlw_bulk_insert_tuple)
+    ->Args({sqlw_bench::IN_MEMORY, 10'000})
+    ->Args({sqlw_bench::TEMP_FILE, 10'000})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,53 @@
+#include "common.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/transaction.hpp"
+#include <benchmark/benchmark.h>
+#include <tuple>
+
+static void raw_savepoint_insert(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        sqlite3_exec(
+            db.con.handle(), "SAVEPOINT _savepoint_", nullptr, nullptr, nullptr);
+
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(
+            db.con.handle(),
+            "INSERT INTO item (id, name, price) VALUES (?1, 'item', 1.5)",
+            -1,
+            &stmt,
+            nullptr);
+        sqlite3_bind_int(stmt, 1, i++);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+
+        sqlite3_exec(
+            db.con.handle(), "RELEASE _savepoint_", nullptr, nullptr, nullptr);
+    }
+}
+BENCHMARK(raw_savepoint_insert)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
+
+static void sqlw_transaction_insert(benchmark::State& state)
+{
+    sqlw_bench::Database db{state};
+    sqlw_bench::storage_label(state);
+    sqlw::Transaction t{&db.con};
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(t(
+            "INSERT INTO item (id, name, price) VALUES (?1, 'item', 1.5)",
+            std::tuple{i++}));
+    }
+}
+BENCHMARK(sqlw_transaction_insert)
+    ->Arg(sqlw_bench::IN_MEMORY)
+    ->Arg(sqlw_bench::TEMP_FILE);
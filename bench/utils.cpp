@@ -0,0 +1,80 @@
+#include "sqlw/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+static constexpr std::string_view NUMBERS[] = {
+    "0",
+    "42",
+    "-17.1234567890123",
+    "994337.001",
+    "123456789012345.001",
+    "3.14159",
+};
+
+static void std_from_chars_double(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (const auto n : NUMBERS)
+        {
+            double r;
+            benchmark::DoNotOptimize(
+                std::from_chars(n.data(), n.data() + n.size(), r));
+            benchmark::DoNotOptimize(r);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::size(NUMBERS));
+}
+BENCHMARK(std_from_chars_double);
+
+static void raw_strtod(benchmark::State& state)
+{
+    // The C library baseline for to_double().
+    std::string buf;
+
+    for (auto _ : state)
+    {
+        for (const auto n : NUMBERS)
+        {
+            buf.assign(n);
+            benchmark::DoNotOptimize(std::strtod(buf.data(), nullptr));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::size(NUMBERS));
+}
+BENCHMARK(raw_strtod);
+
+static void sqlw_to_double(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (const auto n : NUMBERS)
+        {
+            double r = 0;
+            benchmark::DoNotOptimize(sqlw::utils::to_double(n, r));
+            benchmark::DoNotOptimize(r);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::size(NUMBERS));
+}
+BENCHMARK(sqlw_to_double);
+
+static void sqlw_is_numeric(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (const auto n : NUMBERS)
+        {
+            benchmark::DoNotOptimize(sqlw::utils::is_numeric(n));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::size(NUMBERS));
+}
+BENCHMARK(sqlw_is_numeric);
@@ -0,0 +1,46 @@
+#ifndef SQLW_ARRAY_H_
+#define SQLW_ARRAY_H_
+
+#include "sqlite3.h"
+#include <cstddef>
+
+/**
+ * `sqlw_array` table-valued function, registered on every connection.
+ * It yields the elements of an array bound with `Statement::bind(int,
+ * std::span<...>)`, so a single prepared statement serves lists of any
+ * length:
+ *
+ *     SELECT * FROM item WHERE id IN sqlw_array(?)
+ *     SELECT * FROM item JOIN sqlw_array(?) a ON item.id = a.value
+ *
+ * Elements are read from the caller's memory, which must stay alive
+ * while the statement runs.
+ */
+namespace sqlw::array
+{
+enum class ElementType
+{
+    INT64,
+    DOUBLE,
+    TEXT,
+};
+
+/**
+ * Value passed to `sqlite3_bind_pointer` under the `sqlw_array` type.
+ */
+struct Array
+{
+    ElementType type;
+    const void* data;
+    size_t size;
+};
+} // namespace sqlw::array
+
+namespace sqlw::array::internal
+{
+inline constexpr const char* pointer_type = "sqlw_array";
+
+auto register_module(sqlite3* handle) noexcept -> int;
+} // namespace sqlw::array::internal
+
+#endif // SQLW_ARRAY_H_
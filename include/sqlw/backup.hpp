@@ -0,0 +1,166 @@
+#ifndef SQLW_BACKUP_H_
+#define SQLW_BACKUP_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <gsl/pointers>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace sqlw
+{
+struct BackupOptions
+{
+    /**
+     * Pages copied per step. Negative copies everything in one step.
+     */
+    int pages_per_step{64};
+    /**
+     * Pause between steps, letting writers on the source make progress.
+     */
+    std::chrono::milliseconds sleep{0};
+    /**
+     * Pause before retrying a step that found the source busy or locked.
+     */
+    std::chrono::milliseconds busy_sleep{10};
+};
+
+/**
+ * Online copy of a database via `sqlite3_backup_*`.
+ * The source stays usable while the backup runs; it is only locked for
+ * the duration of each step. If the source is written to by another
+ * connection in between, the copy restarts from scratch.
+ *
+ * Backing up into an in-memory connection is a cheap way to warm a read
+ * replica.
+ */
+class Backup
+{
+  public:
+    struct Progress
+    {
+        int remaining{0};
+        int page_count{0};
+
+        /**
+         * Copied share of the source pages.
+         */
+        auto done() const noexcept -> double
+        {
+            return 0 == page_count
+                       ? 0.0
+                       : 1.0 - static_cast<double>(remaining) / page_count;
+        }
+    };
+
+    typedef std::function<void(const Progress&)> progress_callback_t;
+
+    Backup(
+        Connection* destination,
+        Connection* source,
+        std::string_view destination_db = "main",
+        std::string_view source_db = "main");
+
+    ~Backup();
+
+    Backup(const Backup&) = delete;
+    Backup& operator=(const Backup&) = delete;
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_status;
+    }
+
+    /**
+     * Copies up to `pages` pages. Status is DONE once everything is
+     * copied, SQLITE_BUSY or SQLITE_LOCKED if the step can be retried.
+     */
+    auto step(int pages) noexcept -> Backup&;
+
+    auto progress() const noexcept -> Progress;
+
+    /**
+     * Steps until the copy is done, sleeping between steps as configured
+     * and calling `callback` after each of them. Stops early when `stop`
+     * is requested, returning SQLITE_INTERRUPT. Finishes the backup before
+     * returning.
+     */
+    auto run(
+        BackupOptions options = {},
+        progress_callback_t callback = nullptr,
+        std::stop_token stop = {}) -> std::error_code;
+
+    /**
+     * Releases the backup handle and returns the final status.
+     */
+    auto finish() noexcept -> std::error_code;
+
+  private:
+    gsl::owner<sqlite3_backup*> m_backup{nullptr};
+    std::error_code m_status{status::Code::CLOSED_HANDLE};
+};
+
+/**
+ * Runs a `Backup` on a background thread that opens its own connection
+ * to `source_file`, so the caller's connections are never blocked by it.
+ *
+ * @note `destination` must not be used until the job is finished.
+ */
+class BackupJob
+{
+  public:
+    BackupJob(
+        std::string source_file,
+        Connection* destination,
+        BackupOptions options = {});
+
+    /**
+     * Requests the job to stop and waits for it.
+     */
+    ~BackupJob();
+
+    BackupJob(const BackupJob&) = delete;
+    BackupJob& operator=(const BackupJob&) = delete;
+
+    auto progress() const noexcept -> Backup::Progress
+    {
+        return {
+            m_remaining.load(std::memory_order_relaxed),
+            m_page_count.load(std::memory_order_relaxed)};
+    }
+
+    auto is_finished() const noexcept -> bool
+    {
+        return m_finished.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Asks the job to stop after the current step.
+     */
+    auto stop() noexcept -> void
+    {
+        m_thread.request_stop();
+    }
+
+    /**
+     * Waits for the job and returns its result.
+     */
+    auto wait() -> std::error_code;
+
+  private:
+    std::atomic<int> m_remaining{0};
+    std::atomic<int> m_page_count{0};
+    std::atomic<bool> m_finished{false};
+    std::error_code m_status{};
+    std::jthread m_thread;
+};
+} // namespace sqlw
+
+#endif // SQLW_BACKUP_H_
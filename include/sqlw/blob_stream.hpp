@@ -0,0 +1,98 @@
+#ifndef SQLW_BLOB_STREAM_H_
+#define SQLW_BLOB_STREAM_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <gsl/pointers>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace sqlw
+{
+/**
+ * Incremental access to a single BLOB value via `sqlite3_blob_open`.
+ * Reads and writes go through caller buffers at the stream's offset, so
+ * memory use is bounded by the chunk size rather than the blob size.
+ *
+ * @note A blob can't be resized through the stream. Preallocate it with
+ * `zeroblob(N)` or `Statement::bind_zeroblob` and overwrite it in place.
+ */
+class BlobStream
+{
+  public:
+    BlobStream(Connection* connection);
+
+    ~BlobStream();
+
+    BlobStream(const BlobStream&) = delete;
+    BlobStream& operator=(const BlobStream&) = delete;
+
+    BlobStream(BlobStream&&) noexcept;
+    BlobStream& operator=(BlobStream&&) noexcept;
+
+    /**
+     * Opens the blob stored in `column` of the `rowid` row of `table`.
+     */
+    auto open(
+        std::string_view table,
+        std::string_view column,
+        int64_t rowid,
+        bool writable = false,
+        std::string_view database = "main") -> BlobStream&;
+
+    /**
+     * Moves the stream to the same column of another row without
+     * reopening. The offset is reset to 0.
+     */
+    auto reopen(int64_t rowid) noexcept -> BlobStream&;
+
+    auto close() noexcept -> void;
+
+    auto is_open() const noexcept -> bool
+    {
+        return nullptr != m_blob;
+    }
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_status;
+    }
+
+    /**
+     * Size of the blob in bytes.
+     */
+    auto size() const noexcept -> size_t;
+
+    auto offset() const noexcept -> size_t
+    {
+        return m_offset;
+    }
+
+    auto seek(size_t offset) noexcept -> BlobStream&;
+
+    /**
+     * Reads up to `buffer.size()` bytes at the current offset and advances
+     * it. Returns the number of bytes read, 0 at the end of the blob or
+     * on error.
+     */
+    auto read(std::span<std::byte> buffer) noexcept -> size_t;
+
+    /**
+     * Writes `data` at the current offset and advances it. Writing past
+     * the end of the blob fails with SQLITE_ERROR.
+     */
+    auto write(std::span<const std::byte> data) noexcept -> BlobStream&;
+
+  private:
+    Connection* m_connection{nullptr};
+    gsl::owner<sqlite3_blob*> m_blob{nullptr};
+    std::error_code m_status{status::Code::CLOSED_HANDLE};
+    size_t m_offset{0};
+};
+} // namespace sqlw
+
+#endif // SQLW_BLOB_STREAM_H_
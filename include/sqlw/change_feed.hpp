@@ -0,0 +1,155 @@
+#ifndef SQLW_CHANGE_FEED_H_
+#define SQLW_CHANGE_FEED_H_
+
+#include "sqlite3.h"
+#include "sqlw/ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sqlw
+{
+class Connection;
+
+namespace change_feed::internal
+{
+struct Source;
+}
+
+/**
+ * Row changes captured with the update, commit and rollback hooks.
+ *
+ * Changes are buffered per connection while a transaction runs and set
+ * aside when the commit hook runs. The commit hook fires before the commit
+ * is durable and can still fail, so they are published to a bounded
+ * lock-free buffer only once the commit has completed: when a `Statement`
+ * step leaves the connection in autocommit mode. A consumer that reloads
+ * a changed row therefore sees the committed version. Changes are dropped
+ * on rollback. Consumers can pop them from any thread. The writer never
+ * blocks: changes that don't fit are dropped and counted, so a consumer
+ * that sees `dropped()` grow must treat everything as changed.
+ *
+ * @note Like the update hook, the feed misses changes made by
+ * WITHOUT ROWID tables, truncation without a WHERE clause, and
+ * `REPLACE` conflict resolution. `ROLLBACK TO` doesn't fire the rollback
+ * hook, so changes undone by rolling back to a savepoint (as
+ * `Transaction` does on failure) are still published. The feed must
+ * outlive the connections it's attached to.
+ */
+class ChangeFeed
+{
+  public:
+    enum class Operation
+    {
+        INSERT = SQLITE_INSERT,
+        UPDATE = SQLITE_UPDATE,
+        DELETE = SQLITE_DELETE,
+    };
+
+    struct Change
+    {
+        Operation op{Operation::INSERT};
+        std::string database{};
+        std::string table{};
+        int64_t rowid{0};
+        /**
+         * Number of the committed transaction, the same for all of its
+         * changes and increasing over the feed's lifetime.
+         */
+        uint64_t transaction{0};
+    };
+
+    explicit ChangeFeed(size_t capacity = 4096);
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    /**
+     * Installs the hooks on `connection`, replacing any it had.
+     */
+    auto attach(Connection* connection) -> void;
+
+    /**
+     * Removes the hooks. Changes of an open transaction are discarded.
+     * Closing the connection detaches it.
+     */
+    auto detach(Connection* connection) -> void;
+
+    /**
+     * Publishes the changes of the last commit on `connection` if it has
+     * completed. `Statement` calls it after every finished step; call it
+     * after committing through the raw handle.
+     */
+    auto publish(Connection* connection) noexcept -> void;
+
+    /**
+     * Takes the oldest published change.
+     */
+    auto pop(Change& change) noexcept -> bool;
+
+    /**
+     * Takes all published changes.
+     */
+    auto drain() -> std::vector<Change>;
+
+    /**
+     * Number of committed changes that didn't fit into the buffer.
+     */
+    auto dropped() const noexcept -> uint64_t
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of transactions committed with at least one change.
+     */
+    auto transactions() const noexcept -> uint64_t
+    {
+        return m_transactions.load(std::memory_order_relaxed);
+    }
+
+  private:
+    using Source = change_feed::internal::Source;
+
+    RingBuffer<Change> m_changes;
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_transactions{0};
+    std::mutex m_sources_mutex;
+    std::vector<std::unique_ptr<Source>> m_sources;
+
+    static auto on_update(
+        void* source,
+        int op,
+        const char* database,
+        const char* table,
+        sqlite3_int64 rowid) -> void;
+
+    static auto on_commit(void* source) -> int;
+
+    static auto on_rollback(void* source) -> void;
+};
+
+namespace change_feed::internal
+{
+/**
+ * Hook state of one connection, only touched by the thread running its
+ * statements. The connection points at it, so publishing after a step
+ * doesn't search the feed.
+ */
+struct Source
+{
+    ChangeFeed* feed;
+    sqlite3* handle;
+    std::vector<ChangeFeed::Change> pending;
+    /**
+     * Changes of commits that haven't completed yet.
+     */
+    std::vector<ChangeFeed::Change> committed;
+};
+} // namespace change_feed::internal
+} // namespace sqlw
+
+#endif // SQLW_CHANGE_FEED_H_
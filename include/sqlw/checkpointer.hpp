@@ -0,0 +1,170 @@
+#ifndef SQLW_CHECKPOINTER_H_
+#define SQLW_CHECKPOINTER_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace sqlw
+{
+/**
+ * Checkpoints a WAL database from a background thread on its own
+ * connection, so that writers never run checkpoints inline.
+ *
+ * Attached connections get their auto-checkpoint replaced by a WAL hook
+ * that wakes the thread once `passive_frames` new frames were written.
+ * Every checkpoint starts PASSIVE, which never waits. If the WAL is still
+ * bigger than `restart_frames` afterwards, usually because readers hold
+ * old snapshots, it's escalated to RESTART, and past `truncate_frames` to
+ * TRUNCATE, which also shrinks the file. Those wait up to `busy_timeout`
+ * for readers and block writers meanwhile.
+ *
+ * Without a signal the thread still runs a PASSIVE checkpoint every
+ * `interval`, which catches writes from connections it isn't attached to.
+ *
+ * @note The object must outlive the connections it's attached to.
+ */
+class Checkpointer
+{
+  public:
+    enum class Mode
+    {
+        PASSIVE = SQLITE_CHECKPOINT_PASSIVE,
+        FULL = SQLITE_CHECKPOINT_FULL,
+        RESTART = SQLITE_CHECKPOINT_RESTART,
+        TRUNCATE = SQLITE_CHECKPOINT_TRUNCATE,
+    };
+
+    struct Options
+    {
+        /**
+         * Frames written since the last checkpoint that wake the thread.
+         */
+        int passive_frames{1000};
+        /**
+         * WAL size in frames, after a PASSIVE checkpoint, that escalates
+         * to RESTART.
+         */
+        int restart_frames{10000};
+        /**
+         * WAL size in frames, after a PASSIVE checkpoint, that escalates
+         * to TRUNCATE.
+         */
+        int truncate_frames{50000};
+        std::chrono::milliseconds interval{1000};
+        std::chrono::milliseconds busy_timeout{100};
+    };
+
+    struct Stats
+    {
+        uint64_t checkpoints{0};
+        uint64_t restarts{0};
+        uint64_t truncates{0};
+        /**
+         * Escalated checkpoints that gave up waiting for readers.
+         */
+        uint64_t busy{0};
+        uint64_t failures{0};
+        /**
+         * Frames in the WAL, as of the last checkpoint or commit.
+         */
+        int wal_frames{0};
+        /**
+         * Frames copied into the database over all checkpoints.
+         */
+        uint64_t frames_checkpointed{0};
+        std::chrono::nanoseconds last_duration{0};
+        std::chrono::nanoseconds max_duration{0};
+        std::chrono::nanoseconds total_duration{0};
+    };
+
+    Checkpointer(std::string_view file_name, Options options);
+
+    Checkpointer(std::string_view file_name)
+        : Checkpointer(file_name, Options{})
+    {
+    }
+
+    /**
+     * Stops the thread. A running checkpoint is finished first.
+     */
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_connection.status();
+    }
+
+    /**
+     * Disables auto-checkpoint on `connection` and signals the thread
+     * from its commits instead.
+     */
+    auto attach(Connection* connection) noexcept -> void;
+
+    /**
+     * Restores the default auto-checkpoint of `connection`.
+     */
+    auto detach(Connection* connection) noexcept -> void;
+
+    /**
+     * Runs a checkpoint on the calling thread, without escalation.
+     */
+    auto checkpoint(Mode mode) -> std::error_code;
+
+    /**
+     * Wakes the thread for a checkpoint regardless of the WAL size.
+     */
+    auto request() -> void;
+
+    auto stats() const -> Stats;
+
+  private:
+    Options m_options;
+    Connection m_connection;
+    /**
+     * Serializes checkpoints on `m_connection`.
+     */
+    std::mutex m_run_mutex;
+    /**
+     * Backfill position after the last checkpoint.
+     */
+    int m_backfilled{0};
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake_cv;
+    Stats m_stats{};
+    /**
+     * WAL size in frames that wakes the thread.
+     */
+    int m_trigger{0};
+    bool m_requested{false};
+    bool m_stopping{false};
+    std::jthread m_thread;
+
+    auto run() -> void;
+
+    /**
+     * PASSIVE checkpoint, escalated past the thresholds.
+     */
+    auto checkpoint_escalating() -> void;
+
+    /**
+     * One checkpoint, `m_run_mutex` must be held.
+     */
+    auto step(Mode mode, int& log) -> int;
+
+    auto record(std::chrono::steady_clock::time_point started) -> void;
+
+    static auto on_wal(void* self, sqlite3*, const char*, int frames) -> int;
+};
+} // namespace sqlw
+
+#endif // SQLW_CHECKPOINTER_H_
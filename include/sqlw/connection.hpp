@@ -3,17 +3,157 @@
 
 #include "sqlite3.h"
 #include "sqlw/forward.hpp"
+#include "sqlw/function.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <gsl/pointers>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string_view>
 
 namespace sqlw
 {
+class ChangeFeed;
+
+namespace change_feed::internal
+{
+struct Source;
+}
+class QueryStats;
+class SlowQueryLog;
+class Statement;
+
+/**
+ * Cost counters of a prepared statement reported by `sqlite3_stmt_status`.
+ * `autoindexes` is the number of rows inserted into automatic indexes.
+ */
+struct StatementCounters
+{
+    int fullscan_steps{0};
+    int sorts{0};
+    int autoindexes{0};
+    int vm_steps{0};
+    int reprepares{0};
+    int runs{0};
+    int filter_misses{0};
+    int filter_hits{0};
+    int memory_used{0};
+};
+
+/**
+ * Counter values at which `Connection`'s counters callback fires.
+ * Zero disables the check.
+ */
+struct CounterThresholds
+{
+    int fullscan_steps{0};
+    int sorts{0};
+    int autoindexes{0};
+    int vm_steps{0};
+};
+
+/**
+ * Memory statistics of a connection reported by `sqlite3_db_status`.
+ * `*_used` values are in bytes; lookaside values count slots.
+ */
+struct DatabaseStatus
+{
+    int cache_used{0};
+    int cache_hits{0};
+    int cache_misses{0};
+    int cache_writes{0};
+    int cache_spills{0};
+    int lookaside_used{0};
+    int lookaside_highwater{0};
+    int lookaside_hits{0};
+    int lookaside_misses_size{0};
+    int lookaside_misses_full{0};
+    int schema_used{0};
+    int statements_used{0};
+
+    /**
+     * Share of page lookups served from the cache, 0 without lookups.
+     */
+    auto cache_hit_rate() const noexcept -> double
+    {
+        const int lookups = cache_hits + cache_misses;
+        return 0 == lookups ? 0.0 : static_cast<double>(cache_hits) / lookups;
+    }
+
+    /**
+     * Share of allocation requests served from lookaside slots.
+     */
+    auto lookaside_hit_rate() const noexcept -> double
+    {
+        const int requests =
+            lookaside_hits + lookaside_misses_size + lookaside_misses_full;
+        return 0 == requests ? 0.0
+                             : static_cast<double>(lookaside_hits) / requests;
+    }
+};
+
+/**
+ * Memory-mapped I/O state of the main database. SQLite doesn't count
+ * pages served from the map, so `mapped_pages` is the number of database
+ * pages that fall within the mapping limit, i.e. the pages that are read
+ * without a `read()` copy.
+ */
+struct MmapStatus
+{
+    int64_t limit{0};
+    int64_t page_size{0};
+    int64_t page_count{0};
+    int64_t mapped_pages{0};
+
+    /**
+     * Share of the database pages covered by the mapping.
+     */
+    auto coverage() const noexcept -> double
+    {
+        return 0 == page_count
+                   ? 0.0
+                   : static_cast<double>(mapped_pages) / page_count;
+    }
+};
+
+typedef std::function<void(std::string_view sql, const StatementCounters&)>
+    counters_callback_t;
+
+namespace connection::internal
+{
+/**
+ * State checked by the progress handler. Lives on the heap so that its
+ * address survives moves of the connection.
+ */
+struct InterruptState
+{
+    std::optional<std::chrono::steady_clock::time_point> deadline{};
+    std::stop_token stop_token{};
+    int interval{1000};
+    /**
+     * Code to report for the next SQLITE_INTERRUPT, 0 if none.
+     */
+    std::atomic<int> reason{0};
+};
+} // namespace connection::internal
+
 class Connection
 {
   public:
     Connection(){};
     Connection(std::string_view filename);
 
+    /**
+     * Opens the database with `SQLITE_OPEN_*` flags,
+     * e.g. `SQLITE_OPEN_READONLY`.
+     */
+    Connection(std::string_view filename, int flags);
+
     ~Connection();
 
     Connection(const Connection&) = delete;
@@ -24,6 +164,8 @@ class Connection
 
     auto connect(std::string_view file_name) -> void;
 
+    auto connect(std::string_view file_name, int flags) -> void;
+
     auto handle() const -> sqlite3*
     {
         return m_handle;
@@ -34,11 +176,298 @@ class Connection
         return m_status;
     }
 
+    /**
+     * Finalizes the prepared statements of all live `Statement`s, which
+     * then report CLOSED_HANDLE, and closes the database. Statements
+     * prepared through the C API keep the handle alive as a zombie until
+     * they're finalized. Detaches query stats, the slow query log and
+     * the change feed.
+     */
     auto close() -> void;
 
+    /**
+     * Stops the running statement as soon as possible. Safe to call from
+     * any thread. The statement fails with QUERY_CANCELLED.
+     */
+    auto interrupt() noexcept -> void;
+
+    /**
+     * Makes statements fail with DEADLINE_EXCEEDED once `deadline`
+     * passes. The deadline is checked every `progress_interval` virtual
+     * machine instructions, and it stays until cleared.
+     */
+    auto set_deadline(std::chrono::steady_clock::time_point deadline) -> void;
+
+    auto clear_deadline() -> void;
+
+    auto deadline() const noexcept
+        -> std::optional<std::chrono::steady_clock::time_point>;
+
+    /**
+     * Makes statements fail with QUERY_CANCELLED once a stop is requested
+     * through `token`. Pass a default-constructed token to disable.
+     */
+    auto set_stop_token(std::stop_token token) -> void;
+
+    /**
+     * Number of virtual machine instructions between deadline and stop
+     * token checks. Lower values react faster but cost more.
+     */
+    auto set_progress_interval(int instructions) -> void;
+
+    /**
+     * Status to report for a call that returned SQLITE_INTERRUPT:
+     * QUERY_CANCELLED, DEADLINE_EXCEEDED, or SQLITE_INTERRUPT if the
+     * reason is unknown. Resets the reason.
+     */
+    auto interrupt_status() noexcept -> std::error_code;
+
+    /**
+     * Number of `Statement` objects bound to the connection.
+     */
+    auto live_statements() const noexcept -> size_t;
+
+    /**
+     * Number of prepared statements not yet finalized, including those
+     * prepared through the C API.
+     */
+    auto open_statements() const noexcept -> size_t;
+
+    /**
+     * Heap memory used by all prepared statements, in bytes.
+     */
+    auto statement_memory() const noexcept -> int;
+
+    /**
+     * Number of statements that were still prepared on the last `close`
+     * and were finalized by it. Non-zero values point at leaks.
+     */
+    auto finalized_on_close() const noexcept -> size_t
+    {
+        return m_finalized_on_close;
+    }
+
+    /**
+     * Whether the main database was opened read-only.
+     */
+    auto is_read_only() const noexcept -> bool;
+
+    /**
+     * Gives the connection `slots` lookaside slots of `slot_size` bytes each
+     * for small allocations. Fails with SQLITE_BUSY while any lookaside
+     * memory is in use, so call it right after connecting.
+     */
+    auto set_lookaside(int slot_size, int slots) noexcept -> std::error_code;
+
+    /**
+     * Sets the page cache size of the main database, in pages or, if
+     * negative, in KiB.
+     */
+    auto set_cache_size(int64_t size) noexcept -> std::error_code;
+
+    /**
+     * Allows dirty pages to be spilled to the database file once the cache
+     * holds more than `pages` pages. Zero disables spilling.
+     */
+    auto set_cache_spill(int64_t pages) noexcept -> std::error_code;
+
+    /**
+     * Sets the maximum number of bytes of the database file to access
+     * through memory-mapped I/O. The value is capped by the limit set with
+     * `memory::configure_mmap`. Zero disables memory mapping.
+     */
+    auto set_mmap_size(int64_t bytes) noexcept -> std::error_code;
+
+    auto mmap_status() const noexcept -> MmapStatus;
+
+    /**
+     * Returns cache, lookaside and memory statistics. With `reset` the hit,
+     * miss, write and spill counters and the highwater mark start over.
+     */
+    auto db_status(bool reset = false) const noexcept -> DatabaseStatus;
+
+    /**
+     * Registers a scalar SQL function. Arguments and the result are
+     * converted according to the signature of `fn`: integers, floating
+     * point, `std::string_view` (TEXT), `std::span<const std::byte>` (BLOB)
+     * and `std::optional` of them for NULL. Text and BLOB arguments are
+     * viewed, not copied. Results may also be strings or byte vectors.
+     * Exceptions thrown by `fn` become SQL errors.
+     *
+     * `flags` takes SQLITE_DETERMINISTIC, SQLITE_INNOCUOUS and
+     * SQLITE_DIRECTONLY. Only deterministic functions can be used in
+     * indexes and generated columns.
+     */
+    template <typename F>
+    auto create_function(std::string_view name, F&& fn, int flags = 0)
+        -> std::error_code
+    {
+        return status::Code{function::internal::create_scalar(
+            m_handle,
+            name,
+            std::forward<F>(fn),
+            flags)};
+    }
+
+    /**
+     * Registers an aggregate SQL function with a default-constructed
+     * `State` per group. `step(State&, args...)` is called for every row
+     * and `value(State&)` returns the result of the group.
+     */
+    template <typename State, typename Step, typename Value>
+    auto create_aggregate(
+        std::string_view name,
+        Step&& step,
+        Value&& value,
+        int flags = 0) -> std::error_code
+    {
+        return status::Code{function::internal::create_aggregate<State>(
+            m_handle,
+            name,
+            std::forward<Step>(step),
+            std::forward<Value>(value),
+            flags)};
+    }
+
+    /**
+     * Registers an aggregate that can also be used as a window function.
+     * `inverse(State&, args...)` removes a row that left the window, and
+     * `value(State&)` may be called many times per group.
+     */
+    template <typename State, typename Step, typename Inverse, typename Value>
+    auto create_window_function(
+        std::string_view name,
+        Step&& step,
+        Inverse&& inverse,
+        Value&& value,
+        int flags = 0) -> std::error_code
+    {
+        return status::Code{function::internal::create_window<State>(
+            m_handle,
+            name,
+            std::forward<Step>(step),
+            std::forward<Inverse>(inverse),
+            std::forward<Value>(value),
+            flags)};
+    }
+
+    /**
+     * Statistics collector attached to the connection, if any.
+     */
+    auto query_stats() const -> QueryStats*
+    {
+        return m_query_stats;
+    }
+
+    /**
+     * Slow query log attached to the connection, if any.
+     */
+    auto slow_query_log() const -> SlowQueryLog*
+    {
+        return m_slow_query_log;
+    }
+
+    /**
+     * Change feed attached to the connection, if any.
+     */
+    auto change_feed() const -> ChangeFeed*
+    {
+        return m_change_feed;
+    }
+
+    /**
+     * Sets a callback to invoke whenever a statement finishes with any of
+     * its counters reaching the threshold. Pass nullptr to disable.
+     * Exceptions thrown by the callback are swallowed.
+     */
+    auto on_counters_exceeded(
+        CounterThresholds thresholds,
+        counters_callback_t callback) -> void;
+
+    auto has_counters_callback() const -> bool
+    {
+        return static_cast<bool>(m_counters_callback);
+    }
+
+    /**
+     * Invokes the counters callback if any of the thresholds is reached.
+     */
+    auto check_counters(std::string_view sql, const StatementCounters&) const
+        -> void;
+
   private:
+    friend class ChangeFeed;
+    friend class QueryStats;
+    friend class SlowQueryLog;
+    friend class Statement;
+
     gsl::owner<sqlite3*> m_handle{nullptr};
     std::error_code m_status{status::Code::CLOSED_HANDLE};
+    QueryStats* m_query_stats{nullptr};
+    SlowQueryLog* m_slow_query_log{nullptr};
+    ChangeFeed* m_change_feed{nullptr};
+    change_feed::internal::Source* m_change_source{nullptr};
+    CounterThresholds m_counter_thresholds{};
+    counters_callback_t m_counters_callback{nullptr};
+    /**
+     * Intrusive list of live statements, linked through
+     * `Statement::m_next`.
+     */
+    Statement* m_statements{nullptr};
+    size_t m_statement_count{0};
+    size_t m_finalized_on_close{0};
+    mutable std::mutex m_statements_mutex;
+    std::unique_ptr<connection::internal::InterruptState> m_interrupt{
+        std::make_unique<connection::internal::InterruptState>()};
+
+    auto attach(Statement* stmt) -> void;
+
+    auto detach(Statement* stmt) -> void;
+
+    /**
+     * Installs the progress handler while a deadline or a stop token is
+     * set and removes it otherwise.
+     */
+    auto update_progress_handler() -> void;
+};
+
+/**
+ * Sets a deadline on a connection for the lifetime of the object, e.g.
+ * for one call, and restores the previous one afterwards.
+ */
+class ScopedDeadline
+{
+  public:
+    ScopedDeadline(
+        Connection* connection,
+        std::chrono::steady_clock::duration timeout)
+        : m_connection(connection), m_previous(connection->deadline())
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        m_connection->set_deadline(
+            m_previous.has_value() ? std::min(*m_previous, deadline)
+                                   : deadline);
+    }
+
+    ~ScopedDeadline()
+    {
+        if (m_previous.has_value())
+        {
+            m_connection->set_deadline(*m_previous);
+        }
+        else
+        {
+            m_connection->clear_deadline();
+        }
+    }
+
+    ScopedDeadline(const ScopedDeadline&) = delete;
+    ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+  private:
+    Connection* m_connection;
+    std::optional<std::chrono::steady_clock::time_point> m_previous;
 };
 } // namespace sqlw
 
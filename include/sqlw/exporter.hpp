@@ -0,0 +1,83 @@
+#ifndef SQLW_EXPORTER_H_
+#define SQLW_EXPORTER_H_
+
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace sqlw
+{
+/**
+ * Streams the result of a query to a file descriptor as CSV or JSON Lines.
+ *
+ * Rows are formatted into a chunk of `chunk_size` bytes. Full chunks go
+ * to a writer thread, and the next chunk is filled while the previous
+ * one is written, so I/O overlaps with `sqlite3_step`. Memory stays at
+ * two chunks (plus the longest row) whatever the size of the result.
+ *
+ * NULL is written as an empty CSV field or `null`; BLOBs are written
+ * hex-encoded.
+ */
+class Exporter
+{
+  public:
+    enum class Format
+    {
+        CSV,
+        JSON_LINES,
+    };
+
+    struct Options
+    {
+        Format format{Format::CSV};
+        char delimiter{','};
+        /**
+         * Whether to start CSV output with the column names.
+         */
+        bool header{true};
+        size_t chunk_size{64 * 1024};
+    };
+
+    struct Stats
+    {
+        uint64_t rows{0};
+        uint64_t bytes_written{0};
+        uint64_t chunks{0};
+    };
+
+    Exporter(Connection* connection, Options options);
+
+    Exporter(Connection* connection) : Exporter(connection, Options{})
+    {
+    }
+
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+    /**
+     * Runs the first statement in `sql` and writes all of its rows to `fd`.
+     * Write errors are reported as `errno` values.
+     */
+    auto run(
+        std::string_view sql,
+        int fd,
+        std::span<const Statement::bindable_t> params = {}) -> std::error_code;
+
+    auto stats() const noexcept -> const Stats&
+    {
+        return m_stats;
+    }
+
+  private:
+    Connection* m_connection;
+    Options m_options;
+    Stats m_stats{};
+};
+} // namespace sqlw
+
+#endif // SQLW_EXPORTER_H_
@@ -26,6 +26,10 @@ enum class Code : int
     ROLLBACK_ERROR,
     RELEASE_ERROR,
     UNUSED_PARAMETERS_ERROR,
+    MAPPING_ERROR,
+    PARSE_ERROR,
+    QUERY_CANCELLED,
+    DEADLINE_EXCEEDED,
 };
 
 enum class Condition : int
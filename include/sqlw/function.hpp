@@ -0,0 +1,428 @@
+#ifndef SQLW_FUNCTION_H_
+#define SQLW_FUNCTION_H_
+
+#include "sqlite3.h"
+#include "sqlw/row.hpp"
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sqlw::function::internal
+{
+/**
+ * Parameter and result types of a function pointer or a lambda.
+ */
+template <typename F>
+struct callable_traits : callable_traits<decltype(&F::operator())>
+{
+};
+
+template <typename R, typename... Args> struct callable_traits<R (*)(Args...)>
+{
+    typedef R result_t;
+    typedef std::tuple<std::remove_cvref_t<Args>...> args_t;
+};
+
+template <typename C, typename R, typename... Args>
+struct callable_traits<R (C::*)(Args...)> : callable_traits<R (*)(Args...)>
+{
+};
+
+template <typename C, typename R, typename... Args>
+struct callable_traits<R (C::*)(Args...) const>
+    : callable_traits<R (*)(Args...)>
+{
+};
+
+template <typename F>
+using args_t = typename callable_traits<std::decay_t<F>>::args_t;
+
+template <typename F>
+using result_t = typename callable_traits<std::decay_t<F>>::result_t;
+
+/**
+ * Reads an argument. Text and BLOBs are viewed in place, they stay valid
+ * until the function returns.
+ */
+template <typename T> auto read_value(sqlite3_value* value) -> T
+{
+    if constexpr (row::internal::is_optional<T>::value)
+    {
+        if (SQLITE_NULL == sqlite3_value_type(value))
+        {
+            return std::nullopt;
+        }
+
+        return read_value<typename T::value_type>(value);
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        return 0 != sqlite3_value_int64(value);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return static_cast<T>(sqlite3_value_int64(value));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        return static_cast<T>(sqlite3_value_double(value));
+    }
+    else if constexpr (std::same_as<T, std::string_view>)
+    {
+        const auto data =
+            reinterpret_cast<const char*>(sqlite3_value_text(value));
+        return {data, static_cast<size_t>(sqlite3_value_bytes(value))};
+    }
+    else
+    {
+        static_assert(
+            std::same_as<T, std::span<const std::byte>>,
+            "unsupported argument type");
+
+        const auto data =
+            static_cast<const std::byte*>(sqlite3_value_blob(value));
+        return {data, static_cast<size_t>(sqlite3_value_bytes(value))};
+    }
+}
+
+/**
+ * Sets the result of the function from a C++ value.
+ */
+template <typename T>
+auto set_result(sqlite3_context* context, const T& result) -> void
+{
+    if constexpr (row::internal::is_optional<T>::value)
+    {
+        if (result.has_value())
+        {
+            set_result(context, *result);
+        }
+        else
+        {
+            sqlite3_result_null(context);
+        }
+    }
+    else if constexpr (std::same_as<T, std::nullptr_t>)
+    {
+        sqlite3_result_null(context);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        sqlite3_result_int64(context, static_cast<sqlite3_int64>(result));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        sqlite3_result_double(context, static_cast<double>(result));
+    }
+    else if constexpr (
+        std::same_as<T, std::string_view> || row::internal::is_string<T>::value)
+    {
+        sqlite3_result_text64(
+            context,
+            result.data(),
+            result.size(),
+            SQLITE_TRANSIENT,
+            SQLITE_UTF8);
+    }
+    else
+    {
+        static_assert(
+            std::same_as<T, std::span<const std::byte>> ||
+                std::same_as<T, std::vector<std::byte>>,
+            "unsupported result type");
+
+        sqlite3_result_blob64(
+            context,
+            result.data(),
+            result.size(),
+            SQLITE_TRANSIENT);
+    }
+}
+
+/**
+ * Reads `argv` into the parameters of `Args` that follow the first
+ * `Skip` ones.
+ */
+template <typename Args, size_t Skip, size_t... I>
+auto read_args(
+    [[maybe_unused]] sqlite3_value** argv,
+    std::index_sequence<I...>)
+{
+    return std::tuple<std::tuple_element_t<I + Skip, Args>...>{
+        read_value<std::tuple_element_t<I + Skip, Args>>(argv[I])...};
+}
+
+template <typename F, size_t Skip>
+constexpr int arity = static_cast<int>(std::tuple_size_v<args_t<F>> - Skip);
+
+/**
+ * Calls `fn(prefix..., args...)` and sets its result, if any. Exceptions
+ * are turned into SQL errors.
+ */
+template <typename F, size_t Skip, typename... Prefix>
+auto invoke(
+    sqlite3_context* context,
+    sqlite3_value** argv,
+    F& fn,
+    Prefix&... prefix) noexcept -> void
+{
+    try
+    {
+        auto args = read_args<args_t<F>, Skip>(
+            argv,
+            std::make_index_sequence<arity<F, Skip>>{});
+        const auto call = [&](auto&&... arg) {
+            return fn(prefix..., std::forward<decltype(arg)>(arg)...);
+        };
+
+        if constexpr (std::is_void_v<result_t<F>>)
+        {
+            std::apply(call, std::move(args));
+        }
+        else
+        {
+            set_result(context, std::apply(call, std::move(args)));
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        sqlite3_result_error_nomem(context);
+    }
+    catch (const std::exception& e)
+    {
+        sqlite3_result_error(context, e.what(), -1);
+    }
+    catch (...)
+    {
+        sqlite3_result_error(context, "unknown exception", -1);
+    }
+}
+
+template <typename F> struct Scalar
+{
+    F fn;
+
+    static auto call(sqlite3_context* context, int, sqlite3_value** argv)
+        -> void
+    {
+        auto* self = static_cast<Scalar*>(sqlite3_user_data(context));
+        invoke<F, 0>(context, argv, self->fn);
+    }
+};
+
+/**
+ * Callbacks of an aggregate or window function. The state of a group
+ * lives in the memory of `sqlite3_aggregate_context` and is constructed
+ * on the first row, so groups cost no extra allocation.
+ */
+template <typename State, typename Step, typename Inverse, typename Value>
+struct Aggregate
+{
+    struct Slot
+    {
+        alignas(State) std::byte storage[sizeof(State)];
+        bool constructed;
+    };
+
+    static_assert(
+        alignof(State) <= 8,
+        "aggregate state must not need more than 8-byte alignment");
+
+    Step step_fn;
+    /**
+     * std::nullptr_t for plain aggregates.
+     */
+    Inverse inverse_fn;
+    Value value_fn;
+
+    /**
+     * State of the current group, nullptr if out of memory or, unless
+     * `create`, if the group has no rows.
+     */
+    static auto state(sqlite3_context* context, bool create) noexcept
+        -> State*
+    {
+        auto* slot = static_cast<Slot*>(
+            sqlite3_aggregate_context(context, create ? sizeof(Slot) : 0));
+
+        if (nullptr == slot)
+        {
+            return nullptr;
+        }
+
+        if (!slot->constructed)
+        {
+            try
+            {
+                new (slot->storage) State{};
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+
+            slot->constructed = true;
+        }
+
+        return std::launder(reinterpret_cast<State*>(slot->storage));
+    }
+
+    static auto self(sqlite3_context* context) noexcept -> Aggregate*
+    {
+        return static_cast<Aggregate*>(sqlite3_user_data(context));
+    }
+
+    static auto step(sqlite3_context* context, int, sqlite3_value** argv)
+        -> void
+    {
+        if (State* s = state(context, true); nullptr != s)
+        {
+            invoke<Step, 1>(context, argv, self(context)->step_fn, *s);
+        }
+        else
+        {
+            sqlite3_result_error_nomem(context);
+        }
+    }
+
+    static auto inverse(sqlite3_context* context, int, sqlite3_value** argv)
+        -> void
+    {
+        if (State* s = state(context, true); nullptr != s)
+        {
+            invoke<Inverse, 1>(context, argv, self(context)->inverse_fn, *s);
+        }
+        else
+        {
+            sqlite3_result_error_nomem(context);
+        }
+    }
+
+    static auto value(sqlite3_context* context) -> void
+    {
+        if (State* s = state(context, false); nullptr != s)
+        {
+            invoke<Value, 1>(context, nullptr, self(context)->value_fn, *s);
+        }
+        else
+        {
+            State empty{};
+            invoke<Value, 1>(context, nullptr, self(context)->value_fn, empty);
+        }
+    }
+
+    static auto finish(sqlite3_context* context) -> void
+    {
+        value(context);
+
+        if (State* s = state(context, false); nullptr != s)
+        {
+            s->~State();
+        }
+    }
+};
+
+template <typename T> auto destroy(void* p) -> void
+{
+    delete static_cast<T*>(p);
+}
+
+template <typename F>
+auto create_scalar(sqlite3* db, std::string_view name, F&& fn, int flags)
+    -> int
+{
+    typedef Scalar<std::decay_t<F>> scalar_t;
+
+    return sqlite3_create_function_v2(
+        db,
+        std::string{name}.c_str(),
+        arity<F, 0>,
+        SQLITE_UTF8 | flags,
+        new scalar_t{std::forward<F>(fn)},
+        &scalar_t::call,
+        nullptr,
+        nullptr,
+        &destroy<scalar_t>);
+}
+
+template <typename State, typename Step, typename Value>
+auto create_aggregate(
+    sqlite3* db,
+    std::string_view name,
+    Step&& step,
+    Value&& value,
+    int flags) -> int
+{
+    typedef Aggregate<
+        State,
+        std::decay_t<Step>,
+        std::nullptr_t,
+        std::decay_t<Value>>
+        aggregate_t;
+
+    auto* aggregate = new aggregate_t{
+        std::forward<Step>(step),
+        nullptr,
+        std::forward<Value>(value)};
+
+    return sqlite3_create_function_v2(
+        db,
+        std::string{name}.c_str(),
+        arity<Step, 1>,
+        SQLITE_UTF8 | flags,
+        aggregate,
+        nullptr,
+        &aggregate_t::step,
+        &aggregate_t::finish,
+        &destroy<aggregate_t>);
+}
+
+template <typename State, typename Step, typename Inverse, typename Value>
+auto create_window(
+    sqlite3* db,
+    std::string_view name,
+    Step&& step,
+    Inverse&& inverse,
+    Value&& value,
+    int flags) -> int
+{
+    typedef Aggregate<
+        State,
+        std::decay_t<Step>,
+        std::decay_t<Inverse>,
+        std::decay_t<Value>>
+        aggregate_t;
+
+    static_assert(
+        arity<Step, 1> == arity<Inverse, 1>,
+        "step and inverse must take the same arguments");
+
+    auto* aggregate = new aggregate_t{
+        std::forward<Step>(step),
+        std::forward<Inverse>(inverse),
+        std::forward<Value>(value)};
+
+    return sqlite3_create_window_function(
+        db,
+        std::string{name}.c_str(),
+        arity<Step, 1>,
+        SQLITE_UTF8 | flags,
+        aggregate,
+        &aggregate_t::step,
+        &aggregate_t::finish,
+        &aggregate_t::value,
+        &aggregate_t::inverse,
+        &destroy<aggregate_t>);
+}
+} // namespace sqlw::function::internal
+
+#endif // SQLW_FUNCTION_H_
@@ -0,0 +1,137 @@
+#ifndef SQLW_IMPORTER_H_
+#define SQLW_IMPORTER_H_
+
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace sqlw
+{
+/**
+ * Streams CSV or newline-delimited JSON from a file descriptor into a
+ * table.
+ *
+ * A parser thread reads fixed-size chunks and tokenizes them into typed
+ * fields stored in a per-batch arena, so no field is allocated on its
+ * own. The calling thread writes the batches through one reused prepared
+ * INSERT, one transaction per batch. Batches are recycled through a
+ * bounded queue, which caps memory at `queue_depth` batches.
+ *
+ * Unquoted CSV fields are bound as integers or reals if they print back
+ * as the same text, empty ones as NULL, everything else as TEXT. Leading
+ * zeros, exponents or integers beyond int64 are thus left to the column's
+ * affinity. JSON values keep their type; nested objects and arrays are
+ * inserted as JSON text.
+ */
+class Importer
+{
+  public:
+    enum class Format
+    {
+        CSV,
+        NDJSON,
+    };
+
+    struct Options
+    {
+        Format format{Format::CSV};
+        char delimiter{','};
+        /**
+         * Whether the first CSV record holds column names.
+         */
+        bool header{true};
+        /**
+         * Target columns. When empty, they are taken from the CSV header
+         * or the keys of the first JSON object; CSV without a header is
+         * then inserted positionally.
+         */
+        std::vector<std::string> columns{};
+        /**
+         * Records per batch and transaction.
+         */
+        size_t batch_size{1000};
+        /**
+         * Bytes per `read()`. Grows to fit records longer than that.
+         */
+        size_t chunk_size{1 << 20};
+        /**
+         * Batches in flight between the parser and the writer.
+         */
+        size_t queue_depth{4};
+    };
+
+    struct Stats
+    {
+        uint64_t rows_imported{0};
+        uint64_t rows_quarantined{0};
+        uint64_t bytes_read{0};
+        uint64_t batches{0};
+        std::chrono::nanoseconds elapsed{0};
+
+        auto rows_per_second() const noexcept -> double;
+        auto bytes_per_second() const noexcept -> double;
+    };
+
+    /**
+     * Receives records that couldn't be parsed (PARSE_ERROR) or inserted
+     * (the SQLite error), with their 1-based line number.
+     */
+    typedef std::function<
+        void(size_t line, std::string_view record, std::error_code)>
+        quarantine_callback_t;
+
+    typedef std::function<void(const Stats&)> progress_callback_t;
+
+    Importer(Connection* connection, std::string_view table, Options options);
+
+    Importer(Connection* connection, std::string_view table)
+        : Importer(connection, table, Options{})
+    {
+    }
+
+    Importer(const Importer&) = delete;
+    Importer& operator=(const Importer&) = delete;
+
+    auto on_quarantine(quarantine_callback_t callback) -> void
+    {
+        m_quarantine = std::move(callback);
+    }
+
+    /**
+     * Sets a callback to invoke after every committed batch.
+     */
+    auto on_progress(progress_callback_t callback) -> void
+    {
+        m_progress = std::move(callback);
+    }
+
+    /**
+     * Imports everything until EOF. Quarantined records don't fail the
+     * import; read, prepare and commit errors do. Batches committed
+     * before an error stay in the table.
+     */
+    auto run(int fd) -> std::error_code;
+
+    auto stats() const noexcept -> const Stats&
+    {
+        return m_stats;
+    }
+
+  private:
+    Connection* m_connection;
+    std::string m_table;
+    Options m_options;
+    quarantine_callback_t m_quarantine{nullptr};
+    progress_callback_t m_progress{nullptr};
+    Stats m_stats{};
+};
+} // namespace sqlw
+
+#endif // SQLW_IMPORTER_H_
@@ -3,8 +3,9 @@
 
 #include "sqlw/concepts.hpp"
 #include "sqlw/forward.hpp"
-#include <sstream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace sqlw
 {
@@ -14,7 +15,14 @@ namespace sqlw
 class JsonStringResult
 {
   public:
-    JsonStringResult(){};
+    /**
+     * The JSON text is built in memory allocated from `resource`.
+     */
+    explicit JsonStringResult(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_buffer(resource)
+    {
+    }
 
     JsonStringResult(const JsonStringResult&) = delete;
     JsonStringResult& operator=(const JsonStringResult&) = delete;
@@ -37,15 +45,31 @@ class JsonStringResult
      */
     auto get_array_result() -> std::string;
 
+    /**
+     * Returns result as json array allocated from `resource`.
+     */
+    auto get_array_result(std::pmr::memory_resource* resource)
+        -> std::pmr::string;
+
     /**
      * Returns result as json object.
      */
     auto get_object_result() -> std::string;
 
+    /**
+     * Returns result as json object allocated from `resource`.
+     */
+    auto get_object_result(std::pmr::memory_resource* resource)
+        -> std::pmr::string;
+
     auto has_result() -> bool;
 
   private:
-    std::stringstream m_stream;
+    std::pmr::string m_buffer;
+
+    auto array_result() -> std::string_view;
+
+    auto object_result() -> std::string_view;
 };
 } // namespace sqlw
 
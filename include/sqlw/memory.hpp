@@ -0,0 +1,131 @@
+#ifndef SQLW_MEMORY_H_
+#define SQLW_MEMORY_H_
+
+#include "sqlite3.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+
+/**
+ * Startup configuration of SQLite's memory allocation.
+ *
+ * @note Functions that change allocator configuration go through
+ * `sqlite3_config` and therefore only succeed before SQLite is initialized
+ * (i.e. before the first connection is opened) or after `sqlite3_shutdown`.
+ * They return SQLITE_MISUSE otherwise.
+ */
+namespace sqlw
+{
+class Connection;
+}
+
+namespace sqlw::memory
+{
+struct PoolStats
+{
+    /**
+     * Allocations served from size-class free lists.
+     */
+    uint64_t pooled_allocations;
+    /**
+     * Allocations too large for any size class, served by `malloc`.
+     */
+    uint64_t large_allocations;
+    /**
+     * Bytes requested from `malloc` for slabs of the size classes.
+     */
+    uint64_t slab_bytes;
+};
+
+/**
+ * Makes SQLite allocate from a pool of power-of-two size classes
+ * (16 bytes to 4 KiB) carved out of 64 KiB slabs, with a per-thread cache
+ * for every class. Bigger allocations go to `malloc`.
+ * Slabs are never returned to the system.
+ */
+auto use_pool_allocator() noexcept -> std::error_code;
+
+/**
+ * Makes SQLite allocate from a fixed buffer with its memsys5 allocator
+ * (SQLITE_CONFIG_HEAP). `buffer` must outlive all use of SQLite.
+ *
+ * @note Requires SQLite built with SQLITE_ENABLE_MEMSYS5
+ * (the SQLW_ENABLE_MEMSYS5 CMake option).
+ */
+auto use_heap(std::span<std::byte> buffer, int min_allocation = 64) noexcept
+    -> std::error_code;
+
+/**
+ * Preallocates SQLite's page cache in `buffer` (SQLITE_CONFIG_PAGECACHE),
+ * split into as many slots for `page_size` pages as fit. Pages that don't
+ * fit fall back to the general allocator. `buffer` must outlive all use
+ * of SQLite.
+ */
+auto use_page_cache(std::span<std::byte> buffer, int page_size = 4096) noexcept
+    -> std::error_code;
+
+/**
+ * Sets the default memory-mapped I/O size of new connections and the
+ * upper limit `Connection::set_mmap_size` can raise it to
+ * (SQLITE_CONFIG_MMAP_SIZE).
+ */
+auto configure_mmap(int64_t default_size, int64_t max_size) noexcept
+    -> std::error_code;
+
+auto pool_stats() noexcept -> PoolStats;
+
+/**
+ * Sets the heap size past which SQLite starts releasing cache memory.
+ * Negative `bytes` only query the limit. Returns the previous limit.
+ */
+auto set_soft_heap_limit(int64_t bytes) noexcept -> int64_t;
+
+/**
+ * Sets the heap size past which SQLite's allocations fail with
+ * SQLITE_NOMEM. Negative `bytes` only query the limit.
+ * Returns the previous limit.
+ */
+auto set_hard_heap_limit(int64_t bytes) noexcept -> int64_t;
+
+/**
+ * Bytes currently allocated by SQLite. Stays zero, like `highwater`, if
+ * SQLite is built with SQLITE_DEFAULT_MEMSTATUS=0 and
+ * SQLITE_CONFIG_MEMSTATUS isn't turned on before initialization.
+ */
+auto used() noexcept -> int64_t;
+
+auto highwater(bool reset = false) noexcept -> int64_t;
+
+/**
+ * Frees as much cache memory as possible by calling
+ * `sqlite3_db_release_memory` on every open connection that has a mutex.
+ *
+ * Connections without one are skipped, since they may be in use on
+ * another thread: those opened with SQLITE_OPEN_NOMUTEX, such as the
+ * ones of `ParallelScan` and `Checkpointer`, and all of them when SQLite
+ * is built with SQLITE_THREADSAFE=2 (the performance profile). Use the
+ * overload taking a connection from the thread using it for those.
+ */
+auto release_memory() noexcept -> std::error_code;
+
+/**
+ * Frees as much cache memory of `connection` as possible. Must be called
+ * from the thread using the connection.
+ */
+auto release_memory(Connection* connection) noexcept -> std::error_code;
+
+/**
+ * Number of open connections.
+ */
+auto connection_count() noexcept -> size_t;
+} // namespace sqlw::memory
+
+namespace sqlw::memory::internal
+{
+auto register_connection(sqlite3* handle) -> void;
+auto unregister_connection(sqlite3* handle) -> void;
+auto pool_methods() noexcept -> const sqlite3_mem_methods&;
+} // namespace sqlw::memory::internal
+
+#endif // SQLW_MEMORY_H_
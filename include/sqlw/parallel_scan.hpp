@@ -0,0 +1,279 @@
+#ifndef SQLW_PARALLEL_SCAN_H_
+#define SQLW_PARALLEL_SCAN_H_
+
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include "sqlw/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <gsl/util>
+#include <iterator>
+#include <queue>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sqlw
+{
+/**
+ * Inclusive range of an integer key, usually the rowid.
+ */
+struct Partition
+{
+    int64_t first;
+    int64_t last;
+};
+
+/**
+ * Runs one query over many key ranges in parallel, one read-only
+ * connection per worker of a work-stealing pool.
+ *
+ * The query takes the bounds of its partition as parameters ?1 and ?2,
+ * e.g. `SELECT ... FROM t WHERE rowid BETWEEN ? AND ?`. Any integer key
+ * can be used the same way. Make more partitions than readers so that
+ * skewed ones balance out.
+ *
+ * Before each run all readers open a read transaction on the same
+ * snapshot. That requires WAL mode and SQLite built with
+ * SQLITE_ENABLE_SNAPSHOT (the SQLW_ENABLE_SNAPSHOT CMake option).
+ * Otherwise every reader starts its own read transaction right before the
+ * run, which is consistent only if no write commits meanwhile.
+ *
+ * @note Runs must not overlap.
+ */
+class ParallelScan
+{
+  public:
+    ParallelScan(std::string_view file_name, size_t readers);
+
+    ParallelScan(const ParallelScan&) = delete;
+    ParallelScan& operator=(const ParallelScan&) = delete;
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_status;
+    }
+
+    auto readers() const noexcept -> size_t
+    {
+        return m_connections.size();
+    }
+
+    /**
+     * Splits the rowid range of `table` into up to `count` partitions of
+     * equal width.
+     */
+    auto rowid_partitions(std::string_view table, size_t count)
+        -> std::vector<Partition>;
+
+    /**
+     * Appends rows of all partitions to `rows`, in partition order.
+     */
+    template <typename T, typename Allocator>
+    auto query_as(
+        std::string_view sql,
+        std::span<const Partition> partitions,
+        std::vector<T, Allocator>& rows) -> std::error_code;
+
+    /**
+     * Merges rows of all partitions into `rows`, ordered by `less`.
+     * Every partition's rows must already be ordered the same way.
+     */
+    template <typename T, typename Allocator, typename Less>
+    auto query_as_merged(
+        std::string_view sql,
+        std::span<const Partition> partitions,
+        std::vector<T, Allocator>& rows,
+        Less less) -> std::error_code;
+
+    /**
+     * Folds the rows of each partition into `result` with
+     * `combine(result, std::vector<T>&& rows)`, called on the calling
+     * thread in partition order.
+     */
+    template <typename T, typename R, typename Combine>
+    auto reduce(
+        std::string_view sql,
+        std::span<const Partition> partitions,
+        R& result,
+        Combine combine) -> std::error_code;
+
+  private:
+    std::vector<Connection> m_connections;
+    ThreadPool m_pool;
+    std::error_code m_status{status::Code{SQLITE_OK}};
+
+    /**
+     * Opens a read transaction on every reader, on a shared snapshot if
+     * possible.
+     */
+    auto begin_read() -> std::error_code;
+
+    auto end_read() noexcept -> void;
+
+    template <typename T>
+    auto run(
+        std::string_view sql,
+        std::span<const Partition> partitions,
+        std::vector<std::vector<T>>& partials) -> std::error_code;
+};
+
+template <typename T>
+auto ParallelScan::run(
+    std::string_view sql,
+    std::span<const Partition> partitions,
+    std::vector<std::vector<T>>& partials) -> std::error_code
+{
+    if (status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    // Ends the read transactions even if a task throws.
+    const auto ec = begin_read();
+    const auto finish_read = gsl::finally([this]() { end_read(); });
+
+    if (status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    partials.resize(partitions.size());
+    std::vector<std::error_code> results(partitions.size());
+
+    for (size_t p = 0; p < partitions.size(); p++)
+    {
+        m_pool.submit([&, p](size_t worker) {
+            Statement stmt{&m_connections[worker]};
+            results[p] = stmt.query_as(
+                sql,
+                partials[p],
+                std::tuple{partitions[p].first, partitions[p].last});
+        });
+    }
+
+    m_pool.wait();
+
+    for (const auto& result : results)
+    {
+        if (status::Condition::OK != result)
+        {
+            return result;
+        }
+    }
+
+    return status::Code{SQLITE_OK};
+}
+
+template <typename T, typename Allocator>
+auto ParallelScan::query_as(
+    std::string_view sql,
+    std::span<const Partition> partitions,
+    std::vector<T, Allocator>& rows) -> std::error_code
+{
+    std::vector<std::vector<T>> partials;
+    const auto ec = run(sql, partitions, partials);
+
+    if (status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    size_t total = rows.size();
+
+    for (const auto& partial : partials)
+    {
+        total += partial.size();
+    }
+
+    rows.reserve(total);
+
+    for (auto& partial : partials)
+    {
+        std::move(partial.begin(), partial.end(), std::back_inserter(rows));
+    }
+
+    return ec;
+}
+
+template <typename T, typename Allocator, typename Less>
+auto ParallelScan::query_as_merged(
+    std::string_view sql,
+    std::span<const Partition> partitions,
+    std::vector<T, Allocator>& rows,
+    Less less) -> std::error_code
+{
+    std::vector<std::vector<T>> partials;
+    const auto ec = run(sql, partitions, partials);
+
+    if (status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    // Heads of the partials, smallest on top.
+    typedef std::pair<size_t, size_t> head_t;
+    const auto greater = [&](const head_t& a, const head_t& b) {
+        return less(partials[b.first][b.second], partials[a.first][a.second]);
+    };
+    std::priority_queue<head_t, std::vector<head_t>, decltype(greater)> heads{
+        greater};
+    size_t total = rows.size();
+
+    for (size_t p = 0; p < partials.size(); p++)
+    {
+        total += partials[p].size();
+
+        if (!partials[p].empty())
+        {
+            heads.emplace(p, 0);
+        }
+    }
+
+    rows.reserve(total);
+
+    while (!heads.empty())
+    {
+        auto [p, i] = heads.top();
+        heads.pop();
+        rows.push_back(std::move(partials[p][i]));
+
+        if (i + 1 < partials[p].size())
+        {
+            heads.emplace(p, i + 1);
+        }
+    }
+
+    return ec;
+}
+
+template <typename T, typename R, typename Combine>
+auto ParallelScan::reduce(
+    std::string_view sql,
+    std::span<const Partition> partitions,
+    R& result,
+    Combine combine) -> std::error_code
+{
+    std::vector<std::vector<T>> partials;
+    const auto ec = run(sql, partitions, partials);
+
+    if (status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    for (auto& partial : partials)
+    {
+        combine(result, std::move(partial));
+    }
+
+    return ec;
+}
+} // namespace sqlw
+
+#endif // SQLW_PARALLEL_SCAN_H_
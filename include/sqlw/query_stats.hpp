@@ -0,0 +1,194 @@
+#ifndef SQLW_QUERY_STATS_H_
+#define SQLW_QUERY_STATS_H_
+
+#include "sqlite3.h"
+#include "sqlw/forward.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlw
+{
+class Connection;
+
+namespace query_stats::internal
+{
+struct AtomicHistogram;
+} // namespace query_stats::internal
+
+/**
+ * Log-linear (HDR-style) histogram of nanosecond latencies.
+ * Values are bucketed with a relative error of at most 1/8.
+ */
+class Histogram
+{
+  public:
+    static constexpr size_t SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS =
+        SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    static auto bucket_index(uint64_t value) noexcept -> size_t;
+
+    /**
+     * Largest value that falls into the bucket.
+     */
+    static auto bucket_upper_bound(size_t index) noexcept -> uint64_t;
+
+    auto record(uint64_t value) noexcept -> void;
+
+    auto merge(const Histogram& other) noexcept -> void;
+
+    /**
+     * Returns the value below which `percentile` (0..100) of the recorded
+     * values fall.
+     */
+    auto percentile(double percentile) const noexcept -> uint64_t;
+
+    auto count() const noexcept -> uint64_t
+    {
+        return m_count;
+    }
+
+    auto sum() const noexcept -> uint64_t
+    {
+        return m_sum;
+    }
+
+    auto max() const noexcept -> uint64_t
+    {
+        return m_max;
+    }
+
+    auto buckets() const noexcept -> const std::array<uint64_t, BUCKETS>&
+    {
+        return m_buckets;
+    }
+
+  private:
+    friend struct query_stats::internal::AtomicHistogram;
+
+    std::array<uint64_t, BUCKETS> m_buckets{};
+    uint64_t m_count{0};
+    uint64_t m_sum{0};
+    uint64_t m_max{0};
+};
+
+namespace query_stats::internal
+{
+struct AtomicHistogram
+{
+    std::array<std::atomic<uint64_t>, Histogram::BUCKETS> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+    auto record(uint64_t value) noexcept -> void;
+    auto add_to(Histogram& histogram) const noexcept -> void;
+    auto reset() noexcept -> void;
+};
+
+struct Counters
+{
+    std::string fingerprint;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> rows{0};
+    AtomicHistogram prepare_ns;
+    AtomicHistogram step_ns;
+};
+
+/**
+ * Counters of a single thread. Only the owning thread inserts into
+ * `entries`; other threads read them under `mutex`.
+ */
+struct Shard
+{
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<Counters>> entries;
+};
+} // namespace query_stats::internal
+
+/**
+ * Per-query latency statistics aggregated by SQL fingerprint.
+ *
+ * Once attached to a connection, prepare time of every `Statement` and
+ * step time and row count of every executed statement (reported by
+ * `sqlite3_trace_v2`) are accounted to the statement's fingerprint,
+ * i.e. its SQL with literals and parameters replaced by `?`.
+ * Counters are kept per thread, so recording doesn't take locks.
+ *
+ * @note The object must outlive the connections it's attached to.
+ */
+class QueryStats
+{
+  public:
+    struct Entry
+    {
+        std::string fingerprint;
+        uint64_t calls{0};
+        uint64_t rows{0};
+        Histogram prepare_ns;
+        Histogram step_ns;
+    };
+
+    QueryStats();
+
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    /**
+     * Starts collecting statistics of the connection's queries.
+     */
+    auto attach(Connection* connection) noexcept -> std::error_code;
+
+    auto detach(Connection* connection) noexcept -> void;
+
+    /**
+     * Returns merged counters of all threads ordered by total time spent.
+     */
+    auto snapshot() const -> std::vector<Entry>;
+
+    /**
+     * Zeroes all counters.
+     */
+    auto reset() noexcept -> void;
+
+    auto record_prepare(std::string_view sql, uint64_t ns) noexcept -> void;
+
+    auto record_step(std::string_view sql, uint64_t ns, uint64_t rows) noexcept
+        -> void;
+
+    /**
+     * Normalizes `sql` by stripping comments, collapsing whitespace,
+     * lowercasing keywords and replacing literals, parameters and lists
+     * of them with a single `?`.
+     */
+    static auto fingerprint(std::string_view sql) -> std::string;
+
+  private:
+    const uint64_t m_id;
+    mutable std::mutex m_mutex;
+    std::unordered_map<
+        std::thread::id,
+        std::unique_ptr<query_stats::internal::Shard>>
+        m_shards;
+
+    auto shard() noexcept -> query_stats::internal::Shard&;
+
+    auto counters(std::string_view sql) noexcept
+        -> query_stats::internal::Counters*;
+
+    static int trace(unsigned type, void* ctx, void* p, void* x);
+};
+} // namespace sqlw
+
+#endif // SQLW_QUERY_STATS_H_
@@ -0,0 +1,198 @@
+#ifndef SQLW_RESULT_CACHE_H_
+#define SQLW_RESULT_CACHE_H_
+
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlw
+{
+/**
+ * Caches results of read-only queries keyed by SQL and bound parameters.
+ *
+ * Entries are tagged with the data version of the main database
+ * (`SQLITE_FCNTL_DATA_VERSION`, refreshed by a `PRAGMA data_version` step)
+ * and the connection's total change count. Any write, by this or another
+ * connection, makes older entries stale, so a lookup costs a single
+ * pragma step. Least recently used entries are evicted to keep the cache
+ * under `max_bytes`. Only read-only statements that return columns are
+ * cached; transaction control such as `BEGIN` always executes.
+ *
+ * @note Results of non-deterministic functions such as `random()` or
+ * `datetime('now')` are cached like any other until the data changes.
+ *
+ * @note Not thread-safe, just like the connection it wraps. Changes to
+ * attached databases other than TEMP go unnoticed.
+ */
+class ResultCache
+{
+  public:
+    /**
+     * Materialized rows. Values live in one array of cells, text and
+     * BLOBs in one shared buffer.
+     */
+    class Result
+    {
+      public:
+        auto rows() const noexcept -> size_t
+        {
+            return m_columns.empty() ? 0 : m_cells.size() / m_columns.size();
+        }
+
+        auto columns() const noexcept -> const std::vector<std::string>&
+        {
+            return m_columns;
+        }
+
+        auto type(size_t row, size_t column) const noexcept -> Type
+        {
+            return cell(row, column).type;
+        }
+
+        auto int64(size_t row, size_t column) const noexcept -> int64_t
+        {
+            return cell(row, column).integer;
+        }
+
+        auto real(size_t row, size_t column) const noexcept -> double
+        {
+            return cell(row, column).real;
+        }
+
+        /**
+         * TEXT or BLOB value, empty for other types.
+         */
+        auto text(size_t row, size_t column) const noexcept
+            -> std::string_view
+        {
+            const auto& c = cell(row, column);
+
+            // `offset` aliases the value of other types.
+            if (Type::SQL_TEXT != c.type && Type::SQL_BLOB != c.type)
+            {
+                return {};
+            }
+
+            return {m_data.data() + c.offset, c.size};
+        }
+
+        /**
+         * Approximate heap memory held by the result.
+         */
+        auto bytes() const noexcept -> size_t;
+
+      private:
+        friend class ResultCache;
+
+        struct Cell
+        {
+            Type type;
+            uint32_t size;
+            union
+            {
+                int64_t integer;
+                double real;
+                size_t offset;
+            };
+        };
+
+        std::vector<std::string> m_columns;
+        std::vector<Cell> m_cells;
+        std::string m_data;
+
+        auto cell(size_t row, size_t column) const noexcept -> const Cell&
+        {
+            return m_cells[row * m_columns.size() + column];
+        }
+    };
+
+    struct Stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        /**
+         * Misses caused by an entry invalidated by a write.
+         */
+        uint64_t stale{0};
+        uint64_t evictions{0};
+        size_t entries{0};
+        size_t bytes{0};
+
+        auto hit_rate() const noexcept -> double
+        {
+            const uint64_t lookups = hits + misses;
+            return 0 == lookups ? 0.0 : static_cast<double>(hits) / lookups;
+        }
+    };
+
+    ResultCache(Connection* connection, size_t max_bytes);
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /**
+     * Returns the rows of the first statement in `sql`, from the cache if
+     * the data hasn't changed since they were cached. Results of
+     * statements that write, and results bigger than the cache, are
+     * returned but not cached.
+     */
+    auto query(
+        std::string_view sql,
+        std::shared_ptr<const Result>& result,
+        std::span<const Statement::bindable_t> params = {}) -> std::error_code;
+
+    auto clear() noexcept -> void;
+
+    auto stats() const noexcept -> const Stats&
+    {
+        return m_stats;
+    }
+
+  private:
+    struct Entry
+    {
+        std::string key;
+        uint64_t version;
+        std::shared_ptr<const Result> result;
+    };
+
+    typedef std::list<Entry> lru_t;
+
+    Connection* m_connection;
+    size_t m_max_bytes;
+    Statement m_version_stmt;
+    lru_t m_lru;
+    std::unordered_map<std::string_view, lru_t::iterator> m_index;
+    Stats m_stats{};
+
+    /**
+     * Data version of the database, changing on every committed write.
+     */
+    auto version() noexcept -> uint64_t;
+
+    auto execute(
+        std::string_view sql,
+        std::span<const Statement::bindable_t> params,
+        Result& result,
+        bool& cacheable) -> std::error_code;
+
+    auto insert(
+        std::string key,
+        uint64_t version,
+        std::shared_ptr<const Result> result) -> void;
+
+    auto evict(lru_t::iterator it) noexcept -> void;
+};
+} // namespace sqlw
+
+#endif // SQLW_RESULT_CACHE_H_
@@ -0,0 +1,138 @@
+#ifndef SQLW_RING_BUFFER_H_
+#define SQLW_RING_BUFFER_H_
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace sqlw
+{
+/**
+ * Bounded lock-free multi-producer multi-consumer queue
+ * (Dmitry Vyukov's algorithm). Neither side ever blocks: pushing into
+ * a full buffer and popping from an empty one just fail.
+ */
+template <typename T> class RingBuffer
+{
+  public:
+    /**
+     * `capacity` is rounded up to a power of two.
+     */
+    explicit RingBuffer(size_t capacity)
+        : m_mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+          m_cells(std::make_unique<Cell[]>(m_mask + 1))
+    {
+        static_assert(std::is_default_constructible_v<T>);
+
+        for (size_t i = 0; i <= m_mask; i++)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * Returns false if the buffer is full; `value` is left untouched then.
+     */
+    auto try_push(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+        -> bool
+    {
+        Cell* cell;
+        size_t pos = m_enqueue.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                              static_cast<std::ptrdiff_t>(pos);
+
+            if (0 == diff)
+            {
+                if (m_enqueue.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Returns false if the buffer is empty.
+     */
+    auto try_pop(T& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+        -> bool
+    {
+        Cell* cell;
+        size_t pos = m_dequeue.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                              static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (0 == diff)
+            {
+                if (m_dequeue.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->value);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    auto capacity() const noexcept -> size_t
+    {
+        return m_mask + 1;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<size_t> m_enqueue{0};
+    alignas(64) std::atomic<size_t> m_dequeue{0};
+};
+} // namespace sqlw
+
+#endif // SQLW_RING_BUFFER_H_
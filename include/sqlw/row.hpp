@@ -0,0 +1,279 @@
+#ifndef SQLW_ROW_H_
+#define SQLW_ROW_H_
+
+#include "sqlite3.h"
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sqlw::row
+{
+/**
+ * Specialize to map an aggregate's fields to result columns by name
+ * instead of by position.
+ *
+ * template <> struct sqlw::row::column_names<User>
+ * {
+ *     static constexpr std::array<std::string_view, 2> value{"id", "name"};
+ * };
+ */
+template <typename T> struct column_names;
+} // namespace sqlw::row
+
+namespace sqlw::row::internal
+{
+struct any_field
+{
+    template <typename T> operator T() const;
+};
+
+template <typename T, typename... Fields>
+consteval auto field_count() -> size_t
+{
+    if constexpr (requires { T{Fields{}..., any_field{}}; })
+    {
+        return field_count<T, Fields..., any_field>();
+    }
+    else
+    {
+        return sizeof...(Fields);
+    }
+}
+
+template <typename T>
+concept is_tuple_like = requires { std::tuple_size<T>::value; };
+
+template <typename T>
+concept has_column_names = requires {
+    {
+        column_names<T>::value.size()
+    } -> std::convertible_to<size_t>;
+};
+
+template <typename T> struct is_optional : std::false_type
+{
+};
+
+template <typename T> struct is_optional<std::optional<T>> : std::true_type
+{
+};
+
+template <typename T> struct is_string : std::false_type
+{
+};
+
+template <typename Traits, typename Allocator>
+struct is_string<std::basic_string<char, Traits, Allocator>> : std::true_type
+{
+};
+
+template <typename T>
+concept is_pmr_string =
+    is_string<T>::value &&
+    std::same_as<
+        typename T::allocator_type,
+        std::pmr::polymorphic_allocator<char>>;
+
+/**
+ * Number of columns a row of type `T` is made of.
+ */
+template <typename T> consteval auto column_count() -> size_t
+{
+    if constexpr (is_tuple_like<T>)
+    {
+        return std::tuple_size_v<T>;
+    }
+    else
+    {
+        static_assert(
+            std::is_aggregate_v<T>,
+            "row type must be an aggregate or a tuple");
+        return field_count<T>();
+    }
+}
+
+/**
+ * Returns a tuple of references to the fields of an aggregate.
+ */
+template <typename T> auto tie(T& t)
+{
+    constexpr size_t n = column_count<T>();
+
+    static_assert(n > 0 && n <= 16, "row type must have 1 to 16 fields");
+
+    // clang-format off
+    if constexpr (n == 1) { auto& [a] = t; return std::tie(a); }
+    else if constexpr (n == 2) { auto& [a, b] = t; return std::tie(a, b); }
+    else if constexpr (n == 3) { auto& [a, b, c] = t; return std::tie(a, b, c); }
+    else if constexpr (n == 4) { auto& [a, b, c, d] = t; return std::tie(a, b, c, d); }
+    else if constexpr (n == 5) { auto& [a, b, c, d, e] = t; return std::tie(a, b, c, d, e); }
+    else if constexpr (n == 6) { auto& [a, b, c, d, e, f] = t; return std::tie(a, b, c, d, e, f); }
+    else if constexpr (n == 7) { auto& [a, b, c, d, e, f, g] = t; return std::tie(a, b, c, d, e, f, g); }
+    else if constexpr (n == 8) { auto& [a, b, c, d, e, f, g, h] = t; return std::tie(a, b, c, d, e, f, g, h); }
+    else if constexpr (n == 9) { auto& [a, b, c, d, e, f, g, h, i] = t; return std::tie(a, b, c, d, e, f, g, h, i); }
+    else if constexpr (n == 10) { auto& [a, b, c, d, e, f, g, h, i, j] = t; return std::tie(a, b, c, d, e, f, g, h, i, j); }
+    else if constexpr (n == 11) { auto& [a, b, c, d, e, f, g, h, i, j, k] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k); }
+    else if constexpr (n == 12) { auto& [a, b, c, d, e, f, g, h, i, j, k, l] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l); }
+    else if constexpr (n == 13) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m); }
+    else if constexpr (n == 14) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, o] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, o); }
+    else if constexpr (n == 15) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, o, p] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, o, p); }
+    else { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, o, p, q] = t; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, o, p, q); }
+    // clang-format on
+}
+
+/**
+ * Calls `fn` with a reference to every column of the row.
+ */
+template <typename T, typename Fn> auto for_each_field(T& t, Fn&& fn) -> void
+{
+    if constexpr (is_tuple_like<T>)
+    {
+        std::apply([&](auto&... field) { (fn(field), ...); }, t);
+    }
+    else
+    {
+        std::apply([&](auto&... field) { (fn(field), ...); }, tie(t));
+    }
+}
+
+/**
+ * Reads the value of a column straight into `out`. Pmr strings are moved
+ * to `resource` first, unless it's nullptr.
+ */
+template <typename T>
+auto read_column(
+    sqlite3_stmt* stmt,
+    int idx,
+    T& out,
+    std::pmr::memory_resource* resource = nullptr) -> void
+{
+    if constexpr (is_optional<T>::value)
+    {
+        if (SQLITE_NULL == sqlite3_column_type(stmt, idx))
+        {
+            out.reset();
+        }
+        else
+        {
+            read_column(stmt, idx, out.emplace(), resource);
+        }
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        out = 0 != sqlite3_column_int64(stmt, idx);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        out = static_cast<T>(sqlite3_column_int64(stmt, idx));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        out = static_cast<T>(sqlite3_column_double(stmt, idx));
+    }
+    else
+    {
+        static_assert(is_string<T>::value, "unsupported column type");
+
+        if constexpr (is_pmr_string<T>)
+        {
+            // Assignment keeps the allocator of `out`, which is the
+            // default resource for fields of aggregates, so the string
+            // is recreated on `resource` instead.
+            if (nullptr != resource &&
+                *out.get_allocator().resource() != *resource)
+            {
+                std::destroy_at(&out);
+                std::construct_at(&out, resource);
+            }
+        }
+
+        const auto data =
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, idx));
+
+        if (nullptr == data)
+        {
+            out.clear();
+        }
+        else
+        {
+            out.assign(data, sqlite3_column_bytes(stmt, idx));
+        }
+    }
+}
+
+/**
+ * Resolves which result column every field of `T` is read from.
+ * Returns false if the result doesn't have enough (or the named) columns.
+ */
+template <typename T>
+auto map_columns(
+    sqlite3_stmt* stmt,
+    std::array<int, column_count<T>()>& columns) -> bool
+{
+    const int result_columns = sqlite3_column_count(stmt);
+
+    if constexpr (has_column_names<T>)
+    {
+        static_assert(
+            column_names<T>::value.size() == column_count<T>(),
+            "column_names must name every field");
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            columns[i] = -1;
+
+            for (int j = 0; j < result_columns; j++)
+            {
+                if (column_names<T>::value[i] == sqlite3_column_name(stmt, j))
+                {
+                    columns[i] = j;
+                    break;
+                }
+            }
+
+            if (-1 == columns[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    else
+    {
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            columns[i] = static_cast<int>(i);
+        }
+
+        return columns.size() <= static_cast<size_t>(result_columns);
+    }
+}
+
+/**
+ * Fills every field of `row` from the current result row.
+ */
+template <typename T>
+auto read_row(
+    sqlite3_stmt* stmt,
+    const std::array<int, column_count<T>()>& columns,
+    T& row,
+    std::pmr::memory_resource* resource = nullptr) -> void
+{
+    size_t i = 0;
+    for_each_field(row, [&](auto& field) {
+        read_column(stmt, columns[i], field, resource);
+        i++;
+    });
+}
+} // namespace sqlw::row::internal
+
+#endif // SQLW_ROW_H_
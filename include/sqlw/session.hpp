@@ -0,0 +1,140 @@
+#ifndef SQLW_SESSION_H_
+#define SQLW_SESSION_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef SQLITE_ENABLE_SESSION
+
+namespace sqlw
+{
+/**
+ * Records row changes of a connection as changesets that can be applied
+ * to another database, e.g. to keep a standby copy in sync.
+ *
+ * A changeset holds the net change of every modified row, so the cost of
+ * replication follows the write volume, not the size of the database.
+ * Take the changeset after each committed transaction to ship
+ * transactions one at a time. Changesets written to the same file one
+ * after another are applied in order.
+ *
+ * @note Only tables with a PRIMARY KEY are recorded. Requires SQLite
+ * built with SQLITE_ENABLE_SESSION and SQLITE_ENABLE_PREUPDATE_HOOK (the
+ * SQLW_ENABLE_SESSION CMake option).
+ */
+class Session
+{
+  public:
+    enum class Format
+    {
+        CHANGESET,
+        /**
+         * Leaves out old values of updated and deleted rows. Smaller, but
+         * conflicts are detected by primary key only.
+         */
+        PATCHSET,
+    };
+
+    /**
+     * What `apply` does with a change that doesn't match the target.
+     */
+    enum class ConflictPolicy
+    {
+        /**
+         * Skips the change.
+         */
+        OMIT,
+        /**
+         * Overwrites the row of the target. Changes to missing rows and
+         * changes violating constraints are skipped.
+         */
+        REPLACE,
+        /**
+         * Rolls back the whole changeset.
+         */
+        ABORT,
+    };
+
+    Session(
+        Connection* connection,
+        Format format = Format::CHANGESET,
+        std::string_view database = "main");
+
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_status;
+    }
+
+    /**
+     * Records changes of `table`, or of every table if empty.
+     */
+    auto attach(std::string_view table = {}) -> std::error_code;
+
+    /**
+     * Whether no change was recorded since the last `take`.
+     */
+    auto empty() const noexcept -> bool;
+
+    /**
+     * Appends the recorded changes to `changeset` and starts recording
+     * anew.
+     */
+    auto take(std::vector<std::byte>& changeset) -> std::error_code;
+
+    /**
+     * Writes the recorded changes to `fd` in chunks and starts recording
+     * anew.
+     */
+    auto take(int fd) -> std::error_code;
+
+    /**
+     * Applies a changeset or patchset to `target` in one transaction.
+     */
+    static auto apply(
+        Connection* target,
+        std::span<const std::byte> changeset,
+        ConflictPolicy policy) -> std::error_code;
+
+    /**
+     * Applies changesets read from `fd` until its end.
+     */
+    static auto apply(Connection* target, int fd, ConflictPolicy policy)
+        -> std::error_code;
+
+  private:
+    typedef int (*output_t)(void*, const void*, int);
+
+    Connection* m_connection;
+    Format m_format;
+    std::string m_database;
+    /**
+     * Attached tables, an empty name stands for all of them.
+     */
+    std::vector<std::string> m_tables;
+    sqlite3_session* m_session{nullptr};
+    std::error_code m_status{status::Code{SQLITE_OK}};
+
+    auto take(output_t output, void* out) -> std::error_code;
+
+    /**
+     * Replaces the session by an empty one, attached to the same tables.
+     */
+    auto restart() -> std::error_code;
+};
+} // namespace sqlw
+
+#endif // SQLITE_ENABLE_SESSION
+
+#endif // SQLW_SESSION_H_
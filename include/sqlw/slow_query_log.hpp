@@ -0,0 +1,109 @@
+#ifndef SQLW_SLOW_QUERY_LOG_H_
+#define SQLW_SLOW_QUERY_LOG_H_
+
+#include "sqlite3.h"
+#include "sqlw/ring_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sqlw
+{
+class Connection;
+
+/**
+ * Captures statements executed by `Statement::operator()` that take longer
+ * than a threshold, together with their query plan.
+ * Entries are kept in a bounded lock-free buffer; when it's full new
+ * entries are dropped and counted instead of blocking the query.
+ *
+ * @note The object must outlive the connections it's attached to.
+ */
+class SlowQueryLog
+{
+  public:
+    /**
+     * Per-loop statistics from `sqlite3_stmt_scanstatus`. Only collected
+     * when SQLite is built with SQLITE_ENABLE_STMT_SCANSTATUS.
+     */
+    struct ScanStatus
+    {
+        std::string name;
+        std::string explain;
+        int64_t loops{0};
+        int64_t visits{0};
+        double estimated_rows{0};
+    };
+
+    struct Entry
+    {
+        std::chrono::system_clock::time_point logged_at{};
+        std::chrono::nanoseconds duration{0};
+        std::string sql{};
+        /**
+         * SQL with bound parameters substituted, cut to `max_sql_length`.
+         */
+        std::string expanded_sql{};
+        int parameter_count{0};
+        /**
+         * Lines of `EXPLAIN QUERY PLAN`, indented by two spaces per level.
+         */
+        std::vector<std::string> plan{};
+        std::vector<ScanStatus> scans{};
+    };
+
+    SlowQueryLog(std::chrono::nanoseconds threshold, size_t capacity = 64);
+
+    SlowQueryLog(const SlowQueryLog&) = delete;
+    SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+    auto attach(Connection* connection) noexcept -> void;
+
+    auto detach(Connection* connection) noexcept -> void;
+
+    auto threshold() const noexcept -> std::chrono::nanoseconds
+    {
+        return m_threshold.load(std::memory_order_relaxed);
+    }
+
+    auto set_threshold(std::chrono::nanoseconds threshold) noexcept -> void
+    {
+        m_threshold.store(threshold, std::memory_order_relaxed);
+    }
+
+    /**
+     * Captures the statement if it ran for longer than the threshold.
+     */
+    auto record(sqlite3_stmt* stmt, std::chrono::nanoseconds duration) noexcept
+        -> void;
+
+    /**
+     * Takes the oldest entry out of the log.
+     */
+    auto pop(Entry& entry) noexcept -> bool;
+
+    /**
+     * Takes all entries out of the log.
+     */
+    auto drain() -> std::vector<Entry>;
+
+    /**
+     * Number of entries dropped because the log was full.
+     */
+    auto dropped() const noexcept -> uint64_t
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    size_t max_sql_length{1024};
+
+  private:
+    std::atomic<std::chrono::nanoseconds> m_threshold;
+    std::atomic<uint64_t> m_dropped{0};
+    RingBuffer<Entry> m_entries;
+};
+} // namespace sqlw
+
+#endif // SQLW_SLOW_QUERY_LOG_H_
@@ -0,0 +1,97 @@
+#ifndef SQLW_SNAPSHOT_H_
+#define SQLW_SNAPSHOT_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+/**
+ * Whole-database images via `sqlite3_serialize`/`sqlite3_deserialize`.
+ * Loading an image replaces the schema's content with an in-memory
+ * database, so startup is a single read instead of a rebuild.
+ */
+namespace sqlw::snapshot
+{
+/**
+ * Read-only memory mapping of a snapshot file. It must outlive the
+ * connections the snapshot is loaded into.
+ */
+class Mapping
+{
+  public:
+    Mapping() = default;
+
+    ~Mapping();
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    Mapping(Mapping&&) noexcept;
+    Mapping& operator=(Mapping&&) noexcept;
+
+    /**
+     * Maps the file; errors are reported as `errno` values.
+     */
+    auto open(std::string_view path) -> std::error_code;
+
+    auto close() noexcept -> void;
+
+    auto data() const noexcept -> std::span<const std::byte>
+    {
+        return {static_cast<const std::byte*>(m_data), m_size};
+    }
+
+  private:
+    void* m_data{nullptr};
+    size_t m_size{0};
+};
+
+/**
+ * Copies the image of `schema` into `image`.
+ */
+auto serialize(
+    Connection* connection,
+    std::vector<std::byte>& image,
+    std::string_view schema = "main") -> std::error_code;
+
+/**
+ * Writes the image of `schema` to the file at `path`.
+ */
+auto save(
+    Connection* connection,
+    std::string_view path,
+    std::string_view schema = "main") -> std::error_code;
+
+/**
+ * Replaces `schema` with a writable copy of `image`.
+ */
+auto load(
+    Connection* connection,
+    std::span<const std::byte> image,
+    std::string_view schema = "main") -> std::error_code;
+
+/**
+ * Replaces `schema` with a writable copy of the file at `path`, read into
+ * SQLite's memory in one go.
+ */
+auto load_file(
+    Connection* connection,
+    std::string_view path,
+    std::string_view schema = "main") -> std::error_code;
+
+/**
+ * Replaces `schema` with the mapped file without copying it
+ * (SQLITE_DESERIALIZE_READONLY). Writes fail with SQLITE_READONLY.
+ */
+auto load_mapped(
+    Connection* connection,
+    const Mapping& mapping,
+    std::string_view schema = "main") -> std::error_code;
+} // namespace sqlw::snapshot
+
+#endif // SQLW_SNAPSHOT_H_
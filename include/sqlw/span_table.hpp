@@ -0,0 +1,708 @@
+#ifndef SQLW_SPAN_TABLE_H_
+#define SQLW_SPAN_TABLE_H_
+
+#include "sqlite3.h"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/row.hpp"
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace sqlw::span_table::internal
+{
+template <typename T>
+concept is_scalar_column =
+    std::is_arithmetic_v<T> || std::same_as<T, std::string_view> ||
+    row::internal::is_string<T>::value || row::internal::is_optional<T>::value;
+
+/**
+ * Rows that are a single value form one column named `value`.
+ */
+template <typename T> consteval auto column_count() -> size_t
+{
+    if constexpr (is_scalar_column<T>)
+    {
+        return 1;
+    }
+    else
+    {
+        return row::internal::column_count<T>();
+    }
+}
+
+template <typename T, typename Fn>
+auto for_each_column(const T& row, Fn&& fn) -> void
+{
+    if constexpr (is_scalar_column<T>)
+    {
+        fn(row);
+    }
+    else
+    {
+        row::internal::for_each_field(row, fn);
+    }
+}
+
+/**
+ * Calls `fn` with the `column`th field of `row`.
+ */
+template <typename T, typename Fn>
+auto with_column(const T& row, int column, Fn&& fn) -> void
+{
+    int i = 0;
+    for_each_column(row, [&](const auto& field) {
+        if (i++ == column)
+        {
+            fn(field);
+        }
+    });
+}
+
+template <typename T> struct value_type
+{
+    typedef T type;
+};
+
+template <typename T> struct value_type<std::optional<T>>
+{
+    typedef T type;
+};
+
+template <typename T>
+constexpr bool is_numeric = std::is_arithmetic_v<typename value_type<T>::type>;
+
+template <typename T> auto declared_type() -> std::string_view
+{
+    typedef typename value_type<T>::type type;
+
+    if constexpr (std::is_integral_v<type>)
+    {
+        return "INTEGER";
+    }
+    else if constexpr (std::is_floating_point_v<type>)
+    {
+        return "REAL";
+    }
+    else
+    {
+        return "TEXT";
+    }
+}
+
+/**
+ * Compares a field to a constraint value with SQLite's ordering: NULL,
+ * then numbers, then text (BINARY collation).
+ */
+template <typename F>
+auto compare(const F& field, sqlite3_value* value) -> std::weak_ordering
+{
+    if constexpr (row::internal::is_optional<F>::value)
+    {
+        if (!field.has_value())
+        {
+            return std::weak_ordering::less;
+        }
+
+        return compare(*field, value);
+    }
+    else if constexpr (std::is_arithmetic_v<F>)
+    {
+        const int type = sqlite3_value_type(value);
+
+        if constexpr (std::is_integral_v<F>)
+        {
+            if (SQLITE_INTEGER == type)
+            {
+                return static_cast<int64_t>(field) <=>
+                       sqlite3_value_int64(value);
+            }
+        }
+
+        if (SQLITE_INTEGER == type || SQLITE_FLOAT == type)
+        {
+            return std::weak_order(
+                static_cast<double>(field),
+                sqlite3_value_double(value));
+        }
+
+        return std::weak_ordering::less;
+    }
+    else
+    {
+        const auto data =
+            reinterpret_cast<const char*>(sqlite3_value_text(value));
+        const std::string_view text{
+            data,
+            static_cast<size_t>(sqlite3_value_bytes(value))};
+
+        return std::string_view{field}.compare(text) <=> 0;
+    }
+}
+
+/**
+ * Whether `value` compares to the fields of column type `F` by value
+ * alone, i.e. without affinity conversions SQLite would apply.
+ */
+template <typename F> auto is_comparable(sqlite3_value* value) -> bool
+{
+    const int type = is_numeric<F> ? sqlite3_value_numeric_type(value)
+                                   : sqlite3_value_type(value);
+
+    if constexpr (is_numeric<F>)
+    {
+        return SQLITE_INTEGER == type || SQLITE_FLOAT == type;
+    }
+    else
+    {
+        return SQLITE_TEXT == type;
+    }
+}
+
+template <typename F> auto set_result(sqlite3_context* context, const F& field)
+{
+    if constexpr (row::internal::is_optional<F>::value)
+    {
+        if (field.has_value())
+        {
+            set_result(context, *field);
+        }
+        else
+        {
+            sqlite3_result_null(context);
+        }
+    }
+    else if constexpr (std::is_integral_v<F>)
+    {
+        sqlite3_result_int64(context, static_cast<sqlite3_int64>(field));
+    }
+    else if constexpr (std::is_floating_point_v<F>)
+    {
+        sqlite3_result_double(context, static_cast<double>(field));
+    }
+    else
+    {
+        const std::string_view text{field};
+        sqlite3_result_text64(
+            context,
+            text.data(),
+            text.size(),
+            SQLITE_STATIC,
+            SQLITE_UTF8);
+    }
+}
+
+enum Plan : int
+{
+    EQ = 1,
+    GT = 2,
+    GE = 4,
+    LT = 8,
+    LE = 16,
+    ROWID_EQ = 32,
+};
+
+template <typename T> struct State
+{
+    std::span<const T> rows;
+    int sorted_column;
+};
+
+/**
+ * Read-only eponymous virtual table module over `State<T>::rows`.
+ */
+template <typename T> struct Module
+{
+    typedef std::shared_ptr<State<T>> state_t;
+
+    struct Table
+    {
+        sqlite3_vtab base;
+        state_t state;
+    };
+
+    struct Cursor
+    {
+        sqlite3_vtab_cursor base;
+        std::span<const T> rows;
+        size_t position;
+        size_t end;
+    };
+
+    static auto declaration() -> std::string
+    {
+        std::string sql = "CREATE TABLE x(";
+
+        for (size_t i = 0; i < column_count<T>(); i++)
+        {
+            if (0 != i)
+            {
+                sql += ", ";
+            }
+
+            if constexpr (row::internal::has_column_names<T>)
+            {
+                sql += row::column_names<T>::value[i];
+            }
+            else if constexpr (is_scalar_column<T>)
+            {
+                sql += "value";
+            }
+            else
+            {
+                sql += "c" + std::to_string(i);
+            }
+
+            sql += " ";
+            size_t j = 0;
+            for_each_column(T{}, [&](const auto& field) {
+                typedef std::remove_cvref_t<decltype(field)> field_t;
+
+                if (j++ == i)
+                {
+                    sql += declared_type<field_t>();
+                }
+            });
+        }
+
+        return sql + ")";
+    }
+
+    static auto connect(
+        sqlite3* db,
+        void* aux,
+        int,
+        const char* const*,
+        sqlite3_vtab** vtab,
+        char**) -> int
+    {
+        const int rc = sqlite3_declare_vtab(db, declaration().c_str());
+
+        if (SQLITE_OK != rc)
+        {
+            return rc;
+        }
+
+        auto* table = new (std::nothrow) Table{{}, *static_cast<state_t*>(aux)};
+
+        if (nullptr == table)
+        {
+            return SQLITE_NOMEM;
+        }
+
+        sqlite3_vtab_config(db, SQLITE_VTAB_INNOCUOUS);
+        *vtab = &table->base;
+
+        return SQLITE_OK;
+    }
+
+    static auto disconnect(sqlite3_vtab* vtab) -> int
+    {
+        delete reinterpret_cast<Table*>(vtab);
+        return SQLITE_OK;
+    }
+
+    static auto best_index(sqlite3_vtab* vtab, sqlite3_index_info* info)
+        -> int
+    {
+        const auto& state = *reinterpret_cast<Table*>(vtab)->state;
+        const double n = std::max<double>(state.rows.size(), 1);
+        bool text_column = false;
+
+        if (state.sorted_column >= 0 && !state.rows.empty())
+        {
+            with_column(state.rows[0], state.sorted_column, [&](const auto& f) {
+                text_column = !is_numeric<std::remove_cvref_t<decltype(f)>>;
+            });
+        }
+
+        // Constraint used for each plan bit, in argv order.
+        int used[6] = {-1, -1, -1, -1, -1, -1};
+
+        for (int i = 0; i < info->nConstraint; i++)
+        {
+            const auto& c = info->aConstraint[i];
+
+            if (!c.usable)
+            {
+                continue;
+            }
+
+            if (-1 == c.iColumn && SQLITE_INDEX_CONSTRAINT_EQ == c.op)
+            {
+                used[5] = i;
+                continue;
+            }
+
+            if (c.iColumn != state.sorted_column || -1 == c.iColumn ||
+                (text_column &&
+                 0 != sqlite3_stricmp(
+                          "BINARY",
+                          sqlite3_vtab_collation(info, i))))
+            {
+                continue;
+            }
+
+            const int slot = [&]() {
+                switch (c.op)
+                {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                    return 0;
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                    return 1;
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                    return 2;
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                    return 3;
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                    return 4;
+                default:
+                    return -1;
+                }
+            }();
+
+            if (-1 != slot && -1 == used[slot])
+            {
+                used[slot] = i;
+            }
+        }
+
+        int plan = 0;
+        double rows = n;
+
+        if (-1 != used[5])
+        {
+            plan = ROWID_EQ;
+            rows = 1;
+            info->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+        }
+        else if (-1 != used[0])
+        {
+            plan = EQ;
+            rows = std::max(n / 100, 1.0);
+        }
+        else
+        {
+            // One bound per side is enough.
+            for (int slot : {1, 3})
+            {
+                if (-1 != used[slot] || -1 != used[slot + 1])
+                {
+                    const int pick = -1 != used[slot] ? slot : slot + 1;
+                    plan |= 1 << pick;
+                    rows /= 4;
+                }
+            }
+        }
+
+        int argv_index = 0;
+
+        for (int slot = 0; slot < 6; slot++)
+        {
+            if (0 != (plan & (1 << slot)))
+            {
+                info->aConstraintUsage[used[slot]].argvIndex = ++argv_index;
+            }
+        }
+
+        info->idxNum = plan;
+        info->estimatedRows = static_cast<sqlite3_int64>(std::ceil(rows));
+        info->estimatedCost = 0 == plan ? n : std::log2(n) + rows;
+
+        if (1 == info->nOrderBy && !info->aOrderBy[0].desc &&
+            (-1 == info->aOrderBy[0].iColumn ||
+             (state.sorted_column == info->aOrderBy[0].iColumn &&
+              !text_column)))
+        {
+            info->orderByConsumed = 1;
+        }
+
+        return SQLITE_OK;
+    }
+
+    static auto open(sqlite3_vtab*, sqlite3_vtab_cursor** cursor) -> int
+    {
+        auto* c = new (std::nothrow) Cursor{};
+
+        if (nullptr == c)
+        {
+            return SQLITE_NOMEM;
+        }
+
+        *cursor = &c->base;
+        return SQLITE_OK;
+    }
+
+    static auto close(sqlite3_vtab_cursor* cursor) -> int
+    {
+        delete reinterpret_cast<Cursor*>(cursor);
+        return SQLITE_OK;
+    }
+
+    /**
+     * Index of the first row whose sorted column is not `less` than
+     * `value`, or the end if `value` can't be compared directly.
+     */
+    template <typename Less>
+    static auto partition(
+        const State<T>& state,
+        std::span<const T> rows,
+        sqlite3_value* value,
+        bool lower,
+        Less less) -> size_t
+    {
+        bool comparable = false;
+
+        with_column(rows[0], state.sorted_column, [&](const auto& f) {
+            comparable =
+                is_comparable<std::remove_cvref_t<decltype(f)>>(value);
+        });
+
+        if (!comparable)
+        {
+            return lower ? 0 : rows.size();
+        }
+
+        const auto it = std::partition_point(
+            rows.begin(),
+            rows.end(),
+            [&](const T& row) {
+                bool result = false;
+                with_column(row, state.sorted_column, [&](const auto& f) {
+                    result = less(compare(f, value));
+                });
+                return result;
+            });
+
+        return static_cast<size_t>(it - rows.begin());
+    }
+
+    static auto filter(
+        sqlite3_vtab_cursor* cursor,
+        int plan,
+        const char*,
+        int,
+        sqlite3_value** argv) -> int
+    {
+        auto* c = reinterpret_cast<Cursor*>(cursor);
+        const auto& state =
+            *reinterpret_cast<Table*>(cursor->pVtab)->state;
+
+        c->rows = state.rows;
+        c->position = 0;
+        c->end = c->rows.size();
+
+        if (0 == plan || c->rows.empty())
+        {
+            return SQLITE_OK;
+        }
+
+        const auto below = [](std::weak_ordering o) { return o < 0; };
+        const auto not_above = [](std::weak_ordering o) { return o <= 0; };
+
+        for (int slot = 0, arg = 0; slot < 6; slot++)
+        {
+            if (0 == (plan & (1 << slot)))
+            {
+                continue;
+            }
+
+            sqlite3_value* value = argv[arg++];
+
+            if (SQLITE_NULL == sqlite3_value_type(value))
+            {
+                c->end = c->position;
+                return SQLITE_OK;
+            }
+
+            switch (1 << slot)
+            {
+            case ROWID_EQ: {
+                const int type = sqlite3_value_numeric_type(value);
+                const auto rowid = sqlite3_value_int64(value);
+
+                if (SQLITE_INTEGER == type && rowid >= 0 &&
+                    static_cast<uint64_t>(rowid) < c->rows.size())
+                {
+                    c->position = static_cast<size_t>(rowid);
+                    c->end = c->position + 1;
+                }
+                else
+                {
+                    c->end = c->position;
+                }
+
+                break;
+            }
+            case EQ:
+                c->position = partition(state, c->rows, value, true, below);
+                c->end = partition(state, c->rows, value, false, not_above);
+                break;
+            case GT:
+                c->position = partition(state, c->rows, value, true, not_above);
+                break;
+            case GE:
+                c->position = partition(state, c->rows, value, true, below);
+                break;
+            case LT:
+                c->end = partition(state, c->rows, value, false, below);
+                break;
+            case LE:
+                c->end = partition(state, c->rows, value, false, not_above);
+                break;
+            }
+        }
+
+        c->end = std::max(c->end, c->position);
+        return SQLITE_OK;
+    }
+
+    static auto next(sqlite3_vtab_cursor* cursor) -> int
+    {
+        reinterpret_cast<Cursor*>(cursor)->position++;
+        return SQLITE_OK;
+    }
+
+    static auto eof(sqlite3_vtab_cursor* cursor) -> int
+    {
+        const auto* c = reinterpret_cast<Cursor*>(cursor);
+        return c->position >= c->end ? 1 : 0;
+    }
+
+    static auto column(
+        sqlite3_vtab_cursor* cursor,
+        sqlite3_context* context,
+        int column) -> int
+    {
+        const auto* c = reinterpret_cast<Cursor*>(cursor);
+        with_column(c->rows[c->position], column, [&](const auto& f) {
+            set_result(context, f);
+        });
+
+        return SQLITE_OK;
+    }
+
+    static auto rowid(sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid)
+        -> int
+    {
+        *rowid = static_cast<sqlite3_int64>(
+            reinterpret_cast<Cursor*>(cursor)->position);
+        return SQLITE_OK;
+    }
+
+    static auto destroy_state(void* state) -> void
+    {
+        delete static_cast<state_t*>(state);
+    }
+
+    static constexpr auto make_module() -> sqlite3_module
+    {
+        sqlite3_module m{};
+        m.xConnect = &connect;
+        m.xBestIndex = &best_index;
+        m.xDisconnect = &disconnect;
+        m.xDestroy = &disconnect;
+        m.xOpen = &open;
+        m.xClose = &close;
+        m.xFilter = &filter;
+        m.xNext = &next;
+        m.xEof = &eof;
+        m.xColumn = &column;
+        m.xRowid = &rowid;
+
+        return m;
+    }
+
+    /**
+     * No xCreate makes the table eponymous-only.
+     */
+    static constexpr sqlite3_module module = make_module();
+};
+} // namespace sqlw::span_table::internal
+
+namespace sqlw
+{
+/**
+ * Exposes a span of rows to SQL as an eponymous, read-only virtual table,
+ * e.g. `SELECT ... FROM orders JOIN ids USING (id)`. SQLite reads the
+ * caller's memory directly: nothing is copied into the database and text
+ * is returned without copying.
+ *
+ * Rows are aggregates or tuples (columns are named by
+ * `sqlw::row::column_names<T>` if specialized, `c0`, `c1`, ... otherwise)
+ * or single values (one column named `value`). The rowid of a row is its
+ * index in the span.
+ *
+ * If the rows are sorted ascending by `sorted_column`, equality and range
+ * constraints on it are answered by binary search, and ORDER BY on it
+ * (or on rowid) needs no sorting.
+ *
+ * @note The rows must stay alive and unchanged while statements read
+ * the table. After the SpanTable is destroyed the table is empty.
+ */
+template <typename T> class SpanTable
+{
+  public:
+    SpanTable(
+        Connection* connection,
+        std::string_view name,
+        std::span<const T> rows,
+        int sorted_column = -1)
+        : m_state(std::make_shared<span_table::internal::State<T>>(
+              rows,
+              sorted_column))
+    {
+        typedef span_table::internal::Module<T> module_t;
+
+        m_status = status::Code{sqlite3_create_module_v2(
+            connection->handle(),
+            std::string{name}.c_str(),
+            &module_t::module,
+            new typename module_t::state_t{m_state},
+            &module_t::destroy_state)};
+    }
+
+    ~SpanTable()
+    {
+        m_state->rows = {};
+    }
+
+    SpanTable(const SpanTable&) = delete;
+    SpanTable& operator=(const SpanTable&) = delete;
+
+    auto status() const noexcept -> std::error_code
+    {
+        return m_status;
+    }
+
+    auto rows() const noexcept -> std::span<const T>
+    {
+        return m_state->rows;
+    }
+
+    /**
+     * Points the table at other rows, sorted the same way. Don't call it
+     * while a statement reads the table.
+     */
+    auto reset(std::span<const T> rows) noexcept -> void
+    {
+        m_state->rows = rows;
+    }
+
+  private:
+    std::shared_ptr<span_table::internal::State<T>> m_state;
+    std::error_code m_status{status::Code{SQLITE_OK}};
+};
+} // namespace sqlw
+
+#endif // SQLW_SPAN_TABLE_H_
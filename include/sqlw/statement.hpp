@@ -4,10 +4,14 @@
 #include "gsl/pointers"
 #include "sqlw/connection.hpp"
 #include "sqlw/forward.hpp"
+#include "sqlw/row.hpp"
+#include <array>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <gsl/util>
 #include <memory>
+#include <memory_resource>
 #include <span>
 #include <string>
 #include <string_view>
@@ -15,6 +19,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace sqlw
 {
@@ -63,6 +68,23 @@ class Statement
      */
     auto column_value(Type type, int column_idx) -> std::string;
 
+    /**
+     * Same as above, allocated from `resource`.
+     */
+    auto column_value(
+        Type type,
+        int column_idx,
+        std::pmr::memory_resource* resource) -> std::pmr::string;
+
+    /**
+     * Returns a view of a TEXT or BLOB column; empty for other types.
+     * Unlike `column_value` it builds no `std::string`: the view points at
+     * the value SQLite holds for the current row.
+     *
+     * @note The view is valid until the next step, reset or finalization.
+     */
+    auto column_view(Type type, int column_idx) noexcept -> std::string_view;
+
     auto prepare(std::string_view sql) noexcept -> Statement&;
 
     auto bind(int idx, std::string_view value, Type t = Type::SQL_TEXT) noexcept
@@ -72,8 +94,30 @@ class Statement
 
     auto bind(int idx, int value) noexcept -> Statement&;
 
+    auto bind(int idx, int64_t value) noexcept -> Statement&;
+
+    /**
+     * Binds an array as a single parameter of the `sqlw_array`
+     * table-valued function, e.g. `WHERE id IN sqlw_array(?)`.
+     * The elements aren't copied and must stay alive while the statement
+     * runs.
+     */
+    auto bind(int idx, std::span<const int64_t> values) noexcept
+        -> Statement&;
+
+    auto bind(int idx, std::span<const double> values) noexcept
+        -> Statement&;
+
+    auto bind(int idx, std::span<const std::string_view> values) noexcept
+        -> Statement&;
+
     auto bind(std::span<const bindable_t>) noexcept -> unused_params_t;
 
+    /**
+     * Binds a blob of `size` zero bytes, to be filled with `BlobStream`.
+     */
+    auto bind_zeroblob(int idx, uint64_t size) noexcept -> Statement&;
+
     /**
      * Executes the first statement up until ";".
      * Usefull for INSERT/UPDATE/DELETE.
@@ -85,6 +129,20 @@ class Statement
         return m_status;
     }
 
+    /**
+     * Current prepared statement, for stepping it with the C API.
+     */
+    auto handle() const noexcept -> sqlite3_stmt*
+    {
+        return m_stmt;
+    }
+
+    /**
+     * Returns engine's cost counters of the current prepared statement.
+     * Counters are zeroed afterwards if `reset` is true.
+     */
+    auto counters(bool reset = false) noexcept -> StatementCounters;
+
     /**
      * Prepares and executes all statements passed in `sql`.
      * Executes callback on each row fetch.
@@ -139,15 +197,68 @@ class Statement
     auto operator()(callback_t = nullptr, unused_params_t = {}) noexcept
         -> std::error_code;
 
+    /**
+     * Prepares and executes the first statement passed in `sql` and appends
+     * every result row to `rows`.
+     * Fields of `T` (an aggregate or a tuple) are read positionally, or by
+     * name if `sqlw::row::column_names<T>` is specialized.
+     *
+     * @note Unlike operator() the number of rows is not limited by
+     * SQLW_EXEC_LIMIT. Reserve capacity in `rows` up front if the
+     * expected row count is known.
+     */
+    template <typename T, typename Allocator>
+    auto query_as(
+        std::string_view sql,
+        std::vector<T, Allocator>& rows,
+        std::span<const bindable_t> params = {}) -> std::error_code;
+
+    /**
+     * Same as above but binds parameters passed in the tuple.
+     */
+    template <typename T, typename Allocator, typename... ThingsToBind>
+        requires statement::internal::are_bindable<ThingsToBind...>
+    auto query_as(
+        std::string_view sql,
+        std::vector<T, Allocator>& rows,
+        std::tuple<ThingsToBind...>&& params) -> std::error_code;
+
   private:
+    friend class Connection;
+
     Connection* m_connection{nullptr};
     gsl::owner<sqlite3_stmt*> m_stmt{nullptr};
     std::error_code m_status{status::Code{}};
     gsl::owner<const char*> m_unused_sql{nullptr};
     std::string_view m_sql_string{};
+    Statement* m_prev{nullptr};
+    Statement* m_next{nullptr};
 
     template <typename T>
     auto internal_bind(sqlw::Statement& stmt, const T& x, size_t index) -> bool;
+
+    template <typename... ThingsToBind>
+    auto bind_tuple(std::tuple<ThingsToBind...>&& params) -> void;
+
+    /**
+     * Sets the status from the result of a step or a prepare. Interrupts
+     * are reported as the reason the connection recorded.
+     */
+    auto set_step_status(int rc) noexcept -> void;
+
+    /**
+     * Lets the connection check counters of the finished statement.
+     */
+    auto report_counters() noexcept -> void;
+
+    /**
+     * Publishes the changes of a commit the finished step completed to
+     * the connection's change feed.
+     */
+    auto publish_changes() noexcept -> void;
+
+    template <typename T, typename Allocator>
+    auto fetch_rows(std::vector<T, Allocator>& rows) -> std::error_code;
 };
 
 template <typename T>
@@ -168,19 +279,8 @@ bool Statement::internal_bind(sqlw::Statement& stmt, const T& x, size_t i)
 }
 
 template <typename... ThingsToBind>
-    requires statement::internal::are_bindable<ThingsToBind...>
-auto Statement::operator()(
-    std::string_view sql,
-    callback_t callback,
-    std::tuple<ThingsToBind...>&& params) -> std::error_code
+auto Statement::bind_tuple(std::tuple<ThingsToBind...>&& params) -> void
 {
-    this->prepare(sql);
-
-    if (sqlw::status::Condition::OK != m_status)
-    {
-        return m_status;
-    }
-
     if constexpr (std::tuple_size<std::remove_cvref_t<decltype(params)>>() > 0)
     {
         size_t expected_param_count = sqlite3_bind_parameter_count(m_stmt);
@@ -197,13 +297,25 @@ auto Statement::operator()(
         {
             m_status = sqlw::status::Code::UNUSED_PARAMETERS_ERROR;
         }
+    }
+}
 
-        if (sqlw::status::Condition::OK != m_status)
-        {
-            return m_status;
-        }
+template <typename... ThingsToBind>
+    requires statement::internal::are_bindable<ThingsToBind...>
+auto Statement::operator()(
+    std::string_view sql,
+    callback_t callback,
+    std::tuple<ThingsToBind...>&& params) -> std::error_code
+{
+    this->prepare(sql);
+
+    if (sqlw::status::Condition::OK != m_status)
+    {
+        return m_status;
     }
 
+    this->bind_tuple(std::move(params));
+
     if (sqlw::status::Condition::OK != m_status)
     {
         return m_status;
@@ -221,6 +333,91 @@ auto Statement::operator()(
     return operator()(sql, nullptr, std::move(params));
 }
 
+template <typename T, typename Allocator>
+auto Statement::fetch_rows(std::vector<T, Allocator>& rows) -> std::error_code
+{
+    std::array<int, row::internal::column_count<T>()> columns;
+
+    if (!row::internal::map_columns<T>(m_stmt, columns))
+    {
+        m_status = sqlw::status::Code::MAPPING_ERROR;
+        return m_status;
+    }
+
+    // Strings of rows in a pmr vector are allocated from its resource.
+    std::pmr::memory_resource* resource = nullptr;
+
+    if constexpr (std::same_as<Allocator, std::pmr::polymorphic_allocator<T>>)
+    {
+        resource = rows.get_allocator().resource();
+    }
+
+    int rc = sqlite3_step(m_stmt);
+
+    while (SQLITE_ROW == rc)
+    {
+        row::internal::read_row(m_stmt, columns, rows.emplace_back(), resource);
+        rc = sqlite3_step(m_stmt);
+    }
+
+    set_step_status(rc);
+    m_unused_sql = nullptr;
+    report_counters();
+    publish_changes();
+
+    return m_status;
+}
+
+template <typename T, typename Allocator>
+auto Statement::query_as(
+    std::string_view sql,
+    std::vector<T, Allocator>& rows,
+    std::span<const bindable_t> params) -> std::error_code
+{
+    this->prepare(sql);
+
+    if (sqlw::status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    if (!this->bind(params).empty())
+    {
+        m_status = sqlw::status::Code::UNUSED_PARAMETERS_ERROR;
+    }
+
+    if (sqlw::status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    return fetch_rows(rows);
+}
+
+template <typename T, typename Allocator, typename... ThingsToBind>
+    requires statement::internal::are_bindable<ThingsToBind...>
+auto Statement::query_as(
+    std::string_view sql,
+    std::vector<T, Allocator>& rows,
+    std::tuple<ThingsToBind...>&& params) -> std::error_code
+{
+    this->prepare(sql);
+
+    if (sqlw::status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    this->bind_tuple(std::move(params));
+
+    if (sqlw::status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    return fetch_rows(rows);
+}
+
 } // namespace sqlw
 
 #endif // SQLW_STATEMENT_H_
@@ -0,0 +1,78 @@
+#ifndef SQLW_THREAD_POOL_H_
+#define SQLW_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sqlw
+{
+/**
+ * Fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a queue. Tasks submitted from outside are spread
+ * round-robin, tasks submitted by a worker go to its own queue. A worker
+ * takes from the back of its own queue and, once that's empty, steals
+ * from the front of the others, so uneven tasks balance out.
+ * Tasks get the index of the worker running them, which lets callers keep
+ * per-worker resources such as connections.
+ */
+class ThreadPool
+{
+  public:
+    typedef std::function<void(size_t worker)> task_t;
+
+    explicit ThreadPool(size_t workers);
+
+    /**
+     * Finishes queued tasks and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    auto size() const noexcept -> size_t
+    {
+        return m_queues.size();
+    }
+
+    auto submit(task_t task) -> void;
+
+    /**
+     * Blocks until every submitted task is done. Rethrows the first
+     * exception thrown by a task since the last call.
+     */
+    auto wait() -> void;
+
+  private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_idle_cv;
+    size_t m_queued{0};
+    size_t m_unfinished{0};
+    size_t m_next_queue{0};
+    bool m_stopping{false};
+    std::exception_ptr m_exception{nullptr};
+    std::vector<std::jthread> m_workers;
+
+    auto run(size_t worker) -> void;
+
+    auto try_take(size_t worker, task_t& task) -> bool;
+};
+} // namespace sqlw
+
+#endif // SQLW_THREAD_POOL_H_
@@ -0,0 +1,219 @@
+#include "sqlw/array.hpp"
+#include <cstdint>
+#include <new>
+#include <string_view>
+
+namespace
+{
+using sqlw::array::Array;
+using sqlw::array::ElementType;
+
+enum Column
+{
+    VALUE,
+    POINTER,
+};
+
+struct Cursor
+{
+    sqlite3_vtab_cursor base;
+    const Array* array;
+    size_t position;
+};
+
+auto connect(
+    sqlite3* db,
+    void*,
+    int,
+    const char* const*,
+    sqlite3_vtab** vtab,
+    char**) -> int
+{
+    const int rc =
+        sqlite3_declare_vtab(db, "CREATE TABLE x(value, pointer HIDDEN)");
+
+    if (SQLITE_OK != rc)
+    {
+        return rc;
+    }
+
+    *vtab = static_cast<sqlite3_vtab*>(sqlite3_malloc(sizeof(sqlite3_vtab)));
+
+    if (nullptr == *vtab)
+    {
+        return SQLITE_NOMEM;
+    }
+
+    **vtab = {};
+    sqlite3_vtab_config(db, SQLITE_VTAB_INNOCUOUS);
+
+    return SQLITE_OK;
+}
+
+auto disconnect(sqlite3_vtab* vtab) -> int
+{
+    sqlite3_free(vtab);
+    return SQLITE_OK;
+}
+
+/**
+ * The pointer argument is required; without it the plan is rejected.
+ */
+auto best_index(sqlite3_vtab*, sqlite3_index_info* info) -> int
+{
+    for (int i = 0; i < info->nConstraint; i++)
+    {
+        const auto& c = info->aConstraint[i];
+
+        if (POINTER == c.iColumn && SQLITE_INDEX_CONSTRAINT_EQ == c.op)
+        {
+            if (!c.usable)
+            {
+                return SQLITE_CONSTRAINT;
+            }
+
+            info->aConstraintUsage[i].argvIndex = 1;
+            info->aConstraintUsage[i].omit = 1;
+            info->idxNum = 1;
+            info->estimatedCost = 1000;
+            info->estimatedRows = 1000;
+
+            return SQLITE_OK;
+        }
+    }
+
+    return SQLITE_CONSTRAINT;
+}
+
+auto open(sqlite3_vtab*, sqlite3_vtab_cursor** cursor) -> int
+{
+    auto* c = new (std::nothrow) Cursor{};
+
+    if (nullptr == c)
+    {
+        return SQLITE_NOMEM;
+    }
+
+    *cursor = &c->base;
+    return SQLITE_OK;
+}
+
+auto close(sqlite3_vtab_cursor* cursor) -> int
+{
+    delete reinterpret_cast<Cursor*>(cursor);
+    return SQLITE_OK;
+}
+
+auto filter(
+    sqlite3_vtab_cursor* cursor,
+    int plan,
+    const char*,
+    int argc,
+    sqlite3_value** argv) -> int
+{
+    auto* c = reinterpret_cast<Cursor*>(cursor);
+    c->position = 0;
+    c->array = nullptr;
+
+    if (1 == plan && 1 == argc)
+    {
+        c->array = static_cast<const Array*>(sqlite3_value_pointer(
+            argv[0],
+            sqlw::array::internal::pointer_type));
+    }
+
+    return SQLITE_OK;
+}
+
+auto next(sqlite3_vtab_cursor* cursor) -> int
+{
+    reinterpret_cast<Cursor*>(cursor)->position++;
+    return SQLITE_OK;
+}
+
+auto eof(sqlite3_vtab_cursor* cursor) -> int
+{
+    const auto* c = reinterpret_cast<Cursor*>(cursor);
+    return nullptr == c->array || c->position >= c->array->size ? 1 : 0;
+}
+
+auto column(
+    sqlite3_vtab_cursor* cursor,
+    sqlite3_context* context,
+    int column) -> int
+{
+    const auto* c = reinterpret_cast<Cursor*>(cursor);
+
+    if (VALUE != column)
+    {
+        sqlite3_result_null(context);
+        return SQLITE_OK;
+    }
+
+    switch (c->array->type)
+    {
+    case ElementType::INT64:
+        sqlite3_result_int64(
+            context,
+            static_cast<const int64_t*>(c->array->data)[c->position]);
+        break;
+    case ElementType::DOUBLE:
+        sqlite3_result_double(
+            context,
+            static_cast<const double*>(c->array->data)[c->position]);
+        break;
+    case ElementType::TEXT: {
+        const auto& text =
+            static_cast<const std::string_view*>(c->array->data)[c->position];
+        sqlite3_result_text64(
+            context,
+            text.data(),
+            text.size(),
+            SQLITE_STATIC,
+            SQLITE_UTF8);
+        break;
+    }
+    }
+
+    return SQLITE_OK;
+}
+
+auto rowid(sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid) -> int
+{
+    *rowid = static_cast<sqlite3_int64>(
+        reinterpret_cast<Cursor*>(cursor)->position);
+    return SQLITE_OK;
+}
+
+auto array_module() noexcept -> const sqlite3_module&
+{
+    static const sqlite3_module module = []() {
+        sqlite3_module m{};
+        m.xConnect = &connect;
+        m.xBestIndex = &best_index;
+        m.xDisconnect = &disconnect;
+        m.xDestroy = &disconnect;
+        m.xOpen = &open;
+        m.xClose = &close;
+        m.xFilter = &filter;
+        m.xNext = &next;
+        m.xEof = &eof;
+        m.xColumn = &column;
+        m.xRowid = &rowid;
+
+        return m;
+    }();
+
+    return module;
+}
+} // namespace
+
+int sqlw::array::internal::register_module(sqlite3* handle) noexcept
+{
+    return sqlite3_create_module_v2(
+        handle,
+        pointer_type,
+        &array_module(),
+        nullptr,
+        nullptr);
+}
@@ -0,0 +1,159 @@
+#include "sqlw/backup.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <string>
+
+sqlw::Backup::Backup(
+    sqlw::Connection* destination,
+    sqlw::Connection* source,
+    std::string_view destination_db,
+    std::string_view source_db)
+{
+    const std::string destination_name{destination_db};
+    const std::string source_name{source_db};
+
+    m_backup = sqlite3_backup_init(
+        destination->handle(),
+        destination_name.c_str(),
+        source->handle(),
+        source_name.c_str());
+
+    m_status = status::Code{
+        nullptr == m_backup ? sqlite3_errcode(destination->handle())
+                            : SQLITE_OK};
+}
+
+sqlw::Backup::~Backup()
+{
+    finish();
+}
+
+sqlw::Backup& sqlw::Backup::step(int pages) noexcept
+{
+    if (nullptr == m_backup)
+    {
+        m_status = status::Code::CLOSED_HANDLE;
+        return *this;
+    }
+
+    m_status = status::Code{sqlite3_backup_step(m_backup, pages)};
+
+    return *this;
+}
+
+sqlw::Backup::Progress sqlw::Backup::progress() const noexcept
+{
+    if (nullptr == m_backup)
+    {
+        return {};
+    }
+
+    return {
+        sqlite3_backup_remaining(m_backup),
+        sqlite3_backup_pagecount(m_backup)};
+}
+
+static bool is_retryable(const std::error_code& ec)
+{
+    return ec.value() == SQLITE_BUSY || ec.value() == SQLITE_LOCKED;
+}
+
+std::error_code sqlw::Backup::run(
+    sqlw::BackupOptions options,
+    sqlw::Backup::progress_callback_t callback,
+    std::stop_token stop)
+{
+    while (!stop.stop_requested())
+    {
+        step(options.pages_per_step);
+
+        if (is_retryable(m_status))
+        {
+            std::this_thread::sleep_for(options.busy_sleep);
+            continue;
+        }
+
+        if (callback)
+        {
+            callback(progress());
+        }
+
+        if (status::Condition::DONE == m_status ||
+            status::Condition::OK != m_status)
+        {
+            break;
+        }
+
+        if (options.sleep.count() > 0)
+        {
+            std::this_thread::sleep_for(options.sleep);
+        }
+    }
+
+    const bool stopped =
+        status::Condition::DONE != m_status && stop.stop_requested();
+    const auto ec = finish();
+
+    return stopped ? status::Code{SQLITE_INTERRUPT} : ec;
+}
+
+std::error_code sqlw::Backup::finish() noexcept
+{
+    if (nullptr != m_backup)
+    {
+        const auto last = m_status;
+        const int rc = sqlite3_backup_finish(m_backup);
+        m_backup = nullptr;
+
+        m_status = status::Condition::DONE == last ? last : status::Code{rc};
+    }
+
+    return m_status;
+}
+
+sqlw::BackupJob::BackupJob(
+    std::string source_file,
+    sqlw::Connection* destination,
+    sqlw::BackupOptions options)
+    : m_thread(
+          [this, source_file = std::move(source_file), destination, options](
+              std::stop_token stop) {
+              sqlw::Connection source{source_file, SQLITE_OPEN_READONLY};
+
+              if (status::Condition::OK != source.status())
+              {
+                  m_status = source.status();
+                  m_finished.store(true, std::memory_order_release);
+                  return;
+              }
+
+              sqlw::Backup backup{destination, &source};
+
+              m_status = backup.run(
+                  options,
+                  [this](const Backup::Progress& p) {
+                      m_remaining.store(p.remaining, std::memory_order_relaxed);
+                      m_page_count.store(
+                          p.page_count,
+                          std::memory_order_relaxed);
+                  },
+                  stop);
+              m_finished.store(true, std::memory_order_release);
+          })
+{
+}
+
+sqlw::BackupJob::~BackupJob()
+{
+    stop();
+}
+
+std::error_code sqlw::BackupJob::wait()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    return m_status;
+}
@@ -0,0 +1,162 @@
+#include "sqlw/blob_stream.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <algorithm>
+#include <string>
+
+sqlw::BlobStream::BlobStream(sqlw::Connection* con) : m_connection(con)
+{
+}
+
+sqlw::BlobStream::~BlobStream()
+{
+    this->close();
+}
+
+sqlw::BlobStream::BlobStream(sqlw::BlobStream&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+sqlw::BlobStream& sqlw::BlobStream::operator=(
+    sqlw::BlobStream&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->close();
+
+        m_connection = other.m_connection;
+        m_blob = other.m_blob;
+        m_status = other.m_status;
+        m_offset = other.m_offset;
+
+        other.m_connection = nullptr;
+        other.m_blob = nullptr;
+        other.m_status = status::Code::CLOSED_HANDLE;
+        other.m_offset = 0;
+    }
+
+    return *this;
+}
+
+sqlw::BlobStream& sqlw::BlobStream::open(
+    std::string_view table,
+    std::string_view column,
+    int64_t rowid,
+    bool writable,
+    std::string_view database)
+{
+    this->close();
+
+    const std::string db_name{database};
+    const std::string table_name{table};
+    const std::string column_name{column};
+
+    int rc = sqlite3_blob_open(
+        m_connection->handle(),
+        db_name.c_str(),
+        table_name.c_str(),
+        column_name.c_str(),
+        rowid,
+        writable ? 1 : 0,
+        &m_blob);
+
+    m_status = status::Code{rc};
+
+    return *this;
+}
+
+sqlw::BlobStream& sqlw::BlobStream::reopen(int64_t rowid) noexcept
+{
+    if (nullptr == m_blob)
+    {
+        m_status = status::Code::CLOSED_HANDLE;
+        return *this;
+    }
+
+    m_status = status::Code{sqlite3_blob_reopen(m_blob, rowid)};
+    m_offset = 0;
+
+    return *this;
+}
+
+void sqlw::BlobStream::close() noexcept
+{
+    if (nullptr != m_blob)
+    {
+        sqlite3_blob_close(m_blob);
+        m_blob = nullptr;
+        m_status = status::Code::CLOSED_HANDLE;
+        m_offset = 0;
+    }
+}
+
+size_t sqlw::BlobStream::size() const noexcept
+{
+    return nullptr == m_blob ? 0 : sqlite3_blob_bytes(m_blob);
+}
+
+sqlw::BlobStream& sqlw::BlobStream::seek(size_t offset) noexcept
+{
+    m_offset = std::min(offset, size());
+
+    return *this;
+}
+
+size_t sqlw::BlobStream::read(std::span<std::byte> buffer) noexcept
+{
+    if (nullptr == m_blob)
+    {
+        m_status = status::Code::CLOSED_HANDLE;
+        return 0;
+    }
+
+    const size_t n = std::min(buffer.size(), size() - m_offset);
+
+    if (0 == n)
+    {
+        return 0;
+    }
+
+    int rc = sqlite3_blob_read(
+        m_blob,
+        buffer.data(),
+        static_cast<int>(n),
+        static_cast<int>(m_offset));
+
+    m_status = status::Code{rc};
+
+    if (status::Condition::OK != m_status)
+    {
+        return 0;
+    }
+
+    m_offset += n;
+
+    return n;
+}
+
+sqlw::BlobStream& sqlw::BlobStream::write(
+    std::span<const std::byte> data) noexcept
+{
+    if (nullptr == m_blob)
+    {
+        m_status = status::Code::CLOSED_HANDLE;
+        return *this;
+    }
+
+    int rc = sqlite3_blob_write(
+        m_blob,
+        data.data(),
+        static_cast<int>(data.size()),
+        static_cast<int>(m_offset));
+
+    m_status = status::Code{rc};
+
+    if (status::Condition::OK == m_status)
+    {
+        m_offset += data.size();
+    }
+
+    return *this;
+}
@@ -0,0 +1,158 @@
+#include "sqlw/change_feed.hpp"
+#include "sqlw/connection.hpp"
+#include <iterator>
+#include <utility>
+
+sqlw::ChangeFeed::ChangeFeed(size_t capacity) : m_changes(capacity)
+{
+}
+
+void sqlw::ChangeFeed::attach(sqlw::Connection* connection)
+{
+    if (nullptr != connection->m_change_feed)
+    {
+        connection->m_change_feed->detach(connection);
+    }
+
+    sqlite3* handle = connection->handle();
+    auto source = std::make_unique<Source>(Source{this, handle, {}, {}});
+
+    sqlite3_update_hook(handle, &on_update, source.get());
+    sqlite3_commit_hook(handle, &on_commit, source.get());
+    sqlite3_rollback_hook(handle, &on_rollback, source.get());
+
+    connection->m_change_feed = this;
+    connection->m_change_source = source.get();
+
+    std::lock_guard lock{m_sources_mutex};
+    m_sources.push_back(std::move(source));
+}
+
+void sqlw::ChangeFeed::detach(sqlw::Connection* connection)
+{
+    if (this != connection->m_change_feed)
+    {
+        return;
+    }
+
+    sqlite3* handle = connection->handle();
+    sqlite3_update_hook(handle, nullptr, nullptr);
+    sqlite3_commit_hook(handle, nullptr, nullptr);
+    sqlite3_rollback_hook(handle, nullptr, nullptr);
+
+    const auto source = connection->m_change_source;
+    connection->m_change_feed = nullptr;
+    connection->m_change_source = nullptr;
+
+    std::lock_guard lock{m_sources_mutex};
+    std::erase_if(
+        m_sources,
+        [&](const auto& s) { return source == s.get(); });
+}
+
+void sqlw::ChangeFeed::publish(sqlw::Connection* connection) noexcept
+{
+    sqlite3* handle = connection->handle();
+    const auto source = connection->m_change_source;
+
+    // A transaction is still open, or a COMMIT failed with SQLITE_BUSY.
+    if (this != connection->m_change_feed || source->committed.empty() ||
+        0 == sqlite3_get_autocommit(handle))
+    {
+        return;
+    }
+
+    auto& committed = source->committed;
+    const uint64_t transaction =
+        m_transactions.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    for (auto& change : committed)
+    {
+        change.transaction = transaction;
+
+        if (!m_changes.try_push(std::move(change)))
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    committed.clear();
+}
+
+bool sqlw::ChangeFeed::pop(sqlw::ChangeFeed::Change& change) noexcept
+{
+    return m_changes.try_pop(change);
+}
+
+std::vector<sqlw::ChangeFeed::Change> sqlw::ChangeFeed::drain()
+{
+    std::vector<Change> changes;
+    Change change;
+
+    while (m_changes.try_pop(change))
+    {
+        changes.push_back(std::move(change));
+    }
+
+    return changes;
+}
+
+void sqlw::ChangeFeed::on_update(
+    void* source,
+    int op,
+    const char* database,
+    const char* table,
+    sqlite3_int64 rowid)
+{
+    auto& s = *static_cast<Source*>(source);
+
+    try
+    {
+        s.pending.push_back(
+            {static_cast<Operation>(op), database, table, rowid, 0});
+    }
+    catch (...)
+    {
+        // A lost change must still be visible to consumers.
+        s.feed->m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int sqlw::ChangeFeed::on_commit(void* source)
+{
+    auto& s = *static_cast<Source*>(source);
+
+    // Held back until the commit completes, see `publish`.
+    if (s.committed.empty())
+    {
+        std::swap(s.committed, s.pending);
+    }
+    else
+    {
+        try
+        {
+            s.committed.insert(
+                s.committed.end(),
+                std::make_move_iterator(s.pending.begin()),
+                std::make_move_iterator(s.pending.end()));
+        }
+        catch (...)
+        {
+            s.feed->m_dropped.fetch_add(
+                s.pending.size(),
+                std::memory_order_relaxed);
+        }
+
+        s.pending.clear();
+    }
+
+    // Zero lets the commit proceed.
+    return 0;
+}
+
+void sqlw::ChangeFeed::on_rollback(void* source)
+{
+    auto& s = *static_cast<Source*>(source);
+    s.pending.clear();
+    s.committed.clear();
+}
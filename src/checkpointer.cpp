@@ -0,0 +1,262 @@
+#include "sqlw/checkpointer.hpp"
+#include "sqlw/forward.hpp"
+#include <algorithm>
+
+// SQLITE_DEFAULT_WAL_AUTOCHECKPOINT of the amalgamation.
+static constexpr int default_autocheckpoint = 1000;
+
+sqlw::Checkpointer::Checkpointer(
+    std::string_view file_name,
+    sqlw::Checkpointer::Options options)
+    : m_options(options),
+      m_connection(file_name, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX),
+      m_trigger(options.passive_frames)
+{
+    if (status::Condition::OK != m_connection.status())
+    {
+        return;
+    }
+
+    sqlite3_busy_timeout(
+        m_connection.handle(),
+        static_cast<int>(m_options.busy_timeout.count()));
+
+    m_thread = std::jthread{[this] { run(); }};
+}
+
+sqlw::Checkpointer::~Checkpointer()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_wake_cv.notify_one();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void sqlw::Checkpointer::attach(sqlw::Connection* connection) noexcept
+{
+    // Replaces the hook behind auto-checkpoint.
+    sqlite3_wal_hook(connection->handle(), &on_wal, this);
+}
+
+void sqlw::Checkpointer::detach(sqlw::Connection* connection) noexcept
+{
+    sqlite3_wal_autocheckpoint(connection->handle(), default_autocheckpoint);
+}
+
+std::error_code sqlw::Checkpointer::checkpoint(sqlw::Checkpointer::Mode mode)
+{
+    if (status::Condition::OK != m_connection.status())
+    {
+        return m_connection.status();
+    }
+
+    std::lock_guard lock{m_run_mutex};
+    const auto started = std::chrono::steady_clock::now();
+    int log = 0;
+    const int rc = step(mode, log);
+
+    record(started);
+
+    return status::Code{rc};
+}
+
+void sqlw::Checkpointer::request()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_requested = true;
+    }
+
+    m_wake_cv.notify_one();
+}
+
+sqlw::Checkpointer::Stats sqlw::Checkpointer::stats() const
+{
+    std::lock_guard lock{m_mutex};
+    return m_stats;
+}
+
+void sqlw::Checkpointer::run()
+{
+    std::unique_lock lock{m_mutex};
+
+    while (!m_stopping)
+    {
+        m_wake_cv.wait_for(lock, m_options.interval, [this] {
+            return m_stopping || m_requested;
+        });
+
+        if (m_stopping)
+        {
+            break;
+        }
+
+        m_requested = false;
+        lock.unlock();
+        checkpoint_escalating();
+        lock.lock();
+    }
+}
+
+void sqlw::Checkpointer::checkpoint_escalating()
+{
+    std::lock_guard lock{m_run_mutex};
+    const auto started = std::chrono::steady_clock::now();
+    int log = 0;
+
+    if (SQLITE_OK == step(Mode::PASSIVE, log))
+    {
+        if (log >= m_options.truncate_frames)
+        {
+            step(Mode::TRUNCATE, log);
+        }
+        else if (log >= m_options.restart_frames)
+        {
+            step(Mode::RESTART, log);
+        }
+    }
+
+    record(started);
+
+    std::lock_guard stats_lock{m_mutex};
+
+    // Wake up again once as many frames were appended. A writer that
+    // restarts the WAL resets the trigger in the hook.
+    m_trigger = log + m_options.passive_frames;
+}
+
+int sqlw::Checkpointer::step(sqlw::Checkpointer::Mode mode, int& log)
+{
+    int before = 0;
+
+    {
+        std::lock_guard lock{m_mutex};
+        before = m_stats.wal_frames;
+    }
+
+    sqlite3* handle = m_connection.handle();
+    int backfilled = 0;
+    int rc = sqlite3_wal_checkpoint_v2(
+        handle,
+        nullptr,
+        static_cast<int>(mode),
+        &log,
+        &backfilled);
+
+    // The connection opens the WAL on its first read transaction.
+    if (SQLITE_OK == rc && log < 0)
+    {
+        sqlite3_exec(
+            handle,
+            "PRAGMA schema_version",
+            nullptr,
+            nullptr,
+            nullptr);
+        rc = sqlite3_wal_checkpoint_v2(
+            handle,
+            nullptr,
+            static_cast<int>(mode),
+            &log,
+            &backfilled);
+    }
+
+    // Both are -1 if the database isn't in WAL mode.
+    log = std::max(log, 0);
+    backfilled = std::max(backfilled, 0);
+
+    // A successful TRUNCATE reports an empty WAL, after copying all of it.
+    if (SQLITE_OK == rc && Mode::TRUNCATE == mode)
+    {
+        backfilled = std::max(before, m_backfilled);
+    }
+
+    std::lock_guard lock{m_mutex};
+    m_stats.checkpoints++;
+
+    if (SQLITE_OK == rc || SQLITE_BUSY == rc)
+    {
+        // The backfill position goes back to zero when a writer restarts
+        // the WAL.
+        const int delta = backfilled >= m_backfilled
+                              ? backfilled - m_backfilled
+                              : backfilled;
+        m_stats.frames_checkpointed += static_cast<uint64_t>(delta);
+        m_backfilled = backfilled;
+        m_stats.wal_frames = log;
+    }
+
+    if (SQLITE_OK == rc && Mode::TRUNCATE == mode)
+    {
+        m_backfilled = 0;
+        m_stats.wal_frames = 0;
+        log = 0;
+    }
+
+    if (SQLITE_BUSY == rc)
+    {
+        m_stats.busy++;
+    }
+    else if (SQLITE_OK != rc)
+    {
+        m_stats.failures++;
+    }
+    else if (Mode::RESTART == mode)
+    {
+        m_stats.restarts++;
+    }
+    else if (Mode::TRUNCATE == mode)
+    {
+        m_stats.truncates++;
+    }
+
+    return rc;
+}
+
+void sqlw::Checkpointer::record(std::chrono::steady_clock::time_point started)
+{
+    const auto duration = std::chrono::steady_clock::now() - started;
+    std::lock_guard lock{m_mutex};
+
+    m_stats.last_duration = duration;
+    m_stats.max_duration =
+        std::max(m_stats.max_duration, m_stats.last_duration);
+    m_stats.total_duration += duration;
+}
+
+int sqlw::Checkpointer::on_wal(void* self, sqlite3*, const char*, int frames)
+{
+    auto& c = *static_cast<Checkpointer*>(self);
+    bool wake = false;
+
+    {
+        std::lock_guard lock{c.m_mutex};
+
+        // A shrinking WAL was restarted from its beginning.
+        if (frames < c.m_stats.wal_frames)
+        {
+            c.m_trigger = c.m_options.passive_frames;
+        }
+
+        c.m_stats.wal_frames = frames;
+
+        if (frames >= c.m_trigger && !c.m_requested)
+        {
+            c.m_requested = true;
+            wake = true;
+        }
+    }
+
+    if (wake)
+    {
+        c.m_wake_cv.notify_one();
+    }
+
+    return SQLITE_OK;
+}
@@ -1,11 +1,22 @@
 #include "sqlw/connection.hpp"
+#include "sqlw/array.hpp"
+#include "sqlw/change_feed.hpp"
 #include "sqlw/forward.hpp"
+#include "sqlw/memory.hpp"
+#include "sqlw/statement.hpp"
+#include <algorithm>
+#include <string>
 
 sqlw::Connection::Connection(std::string_view file_name)
 {
     connect(file_name);
 }
 
+sqlw::Connection::Connection(std::string_view file_name, int flags)
+{
+    connect(file_name, flags);
+}
+
 sqlw::Connection::~Connection()
 {
     this->close();
@@ -20,11 +31,42 @@ sqlw::Connection& sqlw::Connection::operator=(sqlw::Connection&& other) noexcept
 {
     if (this != &other)
     {
+        this->close();
+
+        std::scoped_lock lock{m_statements_mutex, other.m_statements_mutex};
+
         m_handle = other.m_handle;
         m_status = other.m_status;
+        m_query_stats = other.m_query_stats;
+        m_slow_query_log = other.m_slow_query_log;
+        m_change_feed = other.m_change_feed;
+        m_change_source = other.m_change_source;
+        m_counter_thresholds = other.m_counter_thresholds;
+        m_counters_callback = std::move(other.m_counters_callback);
+
+        // The handler of the moved handle points at the other's state.
+        std::swap(m_interrupt, other.m_interrupt);
+        other.m_interrupt->deadline.reset();
+        other.m_interrupt->stop_token = {};
+        other.m_interrupt->reason = 0;
+
+        m_statements = other.m_statements;
+        m_statement_count = other.m_statement_count;
+        m_finalized_on_close = other.m_finalized_on_close;
+
+        for (auto stmt = m_statements; nullptr != stmt; stmt = stmt->m_next)
+        {
+            stmt->m_connection = this;
+        }
 
         other.m_handle = nullptr;
         other.m_status = sqlw::status::Code::CLOSED_HANDLE;
+        other.m_query_stats = nullptr;
+        other.m_slow_query_log = nullptr;
+        other.m_change_feed = nullptr;
+        other.m_change_source = nullptr;
+        other.m_statements = nullptr;
+        other.m_statement_count = 0;
     }
 
     return *this;
@@ -32,21 +74,386 @@ sqlw::Connection& sqlw::Connection::operator=(sqlw::Connection&& other) noexcept
 
 void sqlw::Connection::connect(std::string_view file_name)
 {
-    auto rc = sqlite3_open(file_name.data(), &m_handle);
+    connect(file_name, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+}
+
+void sqlw::Connection::connect(std::string_view file_name, int flags)
+{
+    auto rc = sqlite3_open_v2(file_name.data(), &m_handle, flags, nullptr);
 
     m_status = static_cast<status::Code>(rc);
 
     if (status::Condition::OK != m_status)
     {
         this->close();
+        return;
     }
+
+    memory::internal::register_connection(m_handle);
+    update_progress_handler();
+    m_status = status::Code{array::internal::register_module(m_handle)};
 }
 
 void sqlw::Connection::close()
 {
     if (nullptr != m_handle)
     {
-        sqlite3_close(m_handle);
+        {
+            std::lock_guard lock{m_statements_mutex};
+            m_finalized_on_close = 0;
+
+            for (auto stmt = m_statements; nullptr != stmt;)
+            {
+                const auto next = stmt->m_next;
+
+                if (nullptr != stmt->m_stmt)
+                {
+                    sqlite3_finalize(stmt->m_stmt);
+                    stmt->m_stmt = nullptr;
+                    m_finalized_on_close++;
+                }
+
+                stmt->m_status = status::Code::CLOSED_HANDLE;
+                stmt->m_connection = nullptr;
+                stmt->m_prev = nullptr;
+                stmt->m_next = nullptr;
+                stmt = next;
+            }
+
+            m_statements = nullptr;
+            m_statement_count = 0;
+        }
+
+        // Drops the feed's hook state while the handle is still valid.
+        if (nullptr != m_change_feed)
+        {
+            m_change_feed->detach(this);
+        }
+
+        memory::internal::unregister_connection(m_handle);
+        sqlite3_close_v2(m_handle);
         m_handle = nullptr;
+        m_query_stats = nullptr;
+        m_slow_query_log = nullptr;
+    }
+}
+
+static int check_interrupt(void* state) noexcept
+{
+    auto& s = *static_cast<sqlw::connection::internal::InterruptState*>(state);
+
+    if (s.stop_token.stop_requested())
+    {
+        s.reason = static_cast<int>(sqlw::status::Code::QUERY_CANCELLED);
+        return 1;
+    }
+
+    if (s.deadline.has_value() &&
+        std::chrono::steady_clock::now() >= *s.deadline)
+    {
+        s.reason = static_cast<int>(sqlw::status::Code::DEADLINE_EXCEEDED);
+        return 1;
+    }
+
+    return 0;
+}
+
+void sqlw::Connection::update_progress_handler()
+{
+    if (nullptr == m_handle)
+    {
+        return;
+    }
+
+    if (m_interrupt->deadline.has_value() ||
+        m_interrupt->stop_token.stop_possible())
+    {
+        sqlite3_progress_handler(
+            m_handle,
+            m_interrupt->interval,
+            &check_interrupt,
+            m_interrupt.get());
+    }
+    else
+    {
+        sqlite3_progress_handler(m_handle, 0, nullptr, nullptr);
+    }
+}
+
+void sqlw::Connection::interrupt() noexcept
+{
+    m_interrupt->reason = static_cast<int>(status::Code::QUERY_CANCELLED);
+
+    if (nullptr != m_handle)
+    {
+        sqlite3_interrupt(m_handle);
+    }
+}
+
+void sqlw::Connection::set_deadline(
+    std::chrono::steady_clock::time_point deadline)
+{
+    m_interrupt->deadline = deadline;
+    update_progress_handler();
+}
+
+void sqlw::Connection::clear_deadline()
+{
+    m_interrupt->deadline.reset();
+    update_progress_handler();
+}
+
+std::optional<std::chrono::steady_clock::time_point> sqlw::Connection::
+    deadline() const noexcept
+{
+    return m_interrupt->deadline;
+}
+
+void sqlw::Connection::set_stop_token(std::stop_token token)
+{
+    m_interrupt->stop_token = std::move(token);
+    update_progress_handler();
+}
+
+void sqlw::Connection::set_progress_interval(int instructions)
+{
+    m_interrupt->interval = std::max(instructions, 1);
+    update_progress_handler();
+}
+
+std::error_code sqlw::Connection::interrupt_status() noexcept
+{
+    const int reason = m_interrupt->reason.exchange(0);
+
+    if (0 == reason)
+    {
+        return status::Code{SQLITE_INTERRUPT};
+    }
+
+    return status::Code{reason};
+}
+
+size_t sqlw::Connection::live_statements() const noexcept
+{
+    std::lock_guard lock{m_statements_mutex};
+    return m_statement_count;
+}
+
+size_t sqlw::Connection::open_statements() const noexcept
+{
+    size_t count = 0;
+
+    for (auto stmt = sqlite3_next_stmt(m_handle, nullptr); nullptr != stmt;
+         stmt = sqlite3_next_stmt(m_handle, stmt))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+int sqlw::Connection::statement_memory() const noexcept
+{
+    int current = 0;
+    int highwater = 0;
+    sqlite3_db_status(
+        m_handle,
+        SQLITE_DBSTATUS_STMT_USED,
+        &current,
+        &highwater,
+        0);
+
+    return current;
+}
+
+void sqlw::Connection::attach(sqlw::Statement* stmt)
+{
+    std::lock_guard lock{m_statements_mutex};
+
+    stmt->m_prev = nullptr;
+    stmt->m_next = m_statements;
+
+    if (nullptr != m_statements)
+    {
+        m_statements->m_prev = stmt;
+    }
+
+    m_statements = stmt;
+    m_statement_count++;
+}
+
+void sqlw::Connection::detach(sqlw::Statement* stmt)
+{
+    std::lock_guard lock{m_statements_mutex};
+
+    if (nullptr != stmt->m_prev)
+    {
+        stmt->m_prev->m_next = stmt->m_next;
+    }
+    else
+    {
+        m_statements = stmt->m_next;
+    }
+
+    if (nullptr != stmt->m_next)
+    {
+        stmt->m_next->m_prev = stmt->m_prev;
+    }
+
+    stmt->m_prev = nullptr;
+    stmt->m_next = nullptr;
+    m_statement_count--;
+}
+
+bool sqlw::Connection::is_read_only() const noexcept
+{
+    return 1 == sqlite3_db_readonly(m_handle, "main");
+}
+
+std::error_code sqlw::Connection::set_lookaside(
+    int slot_size,
+    int slots) noexcept
+{
+    return status::Code{sqlite3_db_config(
+        m_handle,
+        SQLITE_DBCONFIG_LOOKASIDE,
+        nullptr,
+        slot_size,
+        slots)};
+}
+
+static std::error_code set_pragma(
+    sqlite3* handle,
+    std::string_view pragma,
+    int64_t value) noexcept
+{
+    const auto sql =
+        "PRAGMA " + std::string{pragma} + " = " + std::to_string(value);
+
+    return sqlw::status::Code{
+        sqlite3_exec(handle, sql.c_str(), nullptr, nullptr, nullptr)};
+}
+
+std::error_code sqlw::Connection::set_cache_size(int64_t size) noexcept
+{
+    return set_pragma(m_handle, "cache_size", size);
+}
+
+std::error_code sqlw::Connection::set_cache_spill(int64_t pages) noexcept
+{
+    return set_pragma(m_handle, "cache_spill", pages);
+}
+
+std::error_code sqlw::Connection::set_mmap_size(int64_t bytes) noexcept
+{
+    return set_pragma(m_handle, "mmap_size", bytes);
+}
+
+static int64_t query_pragma(sqlite3* handle, const char* sql) noexcept
+{
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = 0;
+
+    if (SQLITE_OK == sqlite3_prepare_v2(handle, sql, -1, &stmt, nullptr) &&
+        SQLITE_ROW == sqlite3_step(stmt))
+    {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+
+    return value;
+}
+
+sqlw::MmapStatus sqlw::Connection::mmap_status() const noexcept
+{
+    MmapStatus s{};
+    sqlite3_int64 limit = -1;
+
+    if (SQLITE_OK !=
+        sqlite3_file_control(m_handle, "main", SQLITE_FCNTL_MMAP_SIZE, &limit))
+    {
+        return s;
+    }
+
+    s.limit = limit;
+    s.page_size = query_pragma(m_handle, "PRAGMA page_size");
+    s.page_count = query_pragma(m_handle, "PRAGMA page_count");
+
+    if (s.page_size > 0)
+    {
+        s.mapped_pages = std::min(s.page_count, s.limit / s.page_size);
+    }
+
+    return s;
+}
+
+sqlw::DatabaseStatus sqlw::Connection::db_status(bool reset) const noexcept
+{
+    DatabaseStatus s{};
+    int unused = 0;
+
+    auto read = [&](int op, int* current, int* highwater, bool resettable) {
+        const int r = reset && resettable ? 1 : 0;
+        sqlite3_db_status(m_handle, op, current, highwater, r);
+    };
+
+    read(SQLITE_DBSTATUS_CACHE_USED, &s.cache_used, &unused, false);
+    read(SQLITE_DBSTATUS_CACHE_HIT, &s.cache_hits, &unused, true);
+    read(SQLITE_DBSTATUS_CACHE_MISS, &s.cache_misses, &unused, true);
+    read(SQLITE_DBSTATUS_CACHE_WRITE, &s.cache_writes, &unused, true);
+    read(SQLITE_DBSTATUS_CACHE_SPILL, &s.cache_spills, &unused, true);
+    read(
+        SQLITE_DBSTATUS_LOOKASIDE_USED,
+        &s.lookaside_used,
+        &s.lookaside_highwater,
+        true);
+    read(SQLITE_DBSTATUS_LOOKASIDE_HIT, &unused, &s.lookaside_hits, true);
+    read(
+        SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE,
+        &unused,
+        &s.lookaside_misses_size,
+        true);
+    read(
+        SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL,
+        &unused,
+        &s.lookaside_misses_full,
+        true);
+    read(SQLITE_DBSTATUS_SCHEMA_USED, &s.schema_used, &unused, false);
+    read(SQLITE_DBSTATUS_STMT_USED, &s.statements_used, &unused, false);
+
+    return s;
+}
+
+void sqlw::Connection::on_counters_exceeded(
+    sqlw::CounterThresholds thresholds,
+    sqlw::counters_callback_t callback)
+{
+    m_counter_thresholds = thresholds;
+    m_counters_callback = std::move(callback);
+}
+
+static bool is_reached(int value, int threshold)
+{
+    return threshold > 0 && value >= threshold;
+}
+
+void sqlw::Connection::check_counters(
+    std::string_view sql,
+    const sqlw::StatementCounters& counters) const
+{
+    if (!m_counters_callback)
+    {
+        return;
+    }
+
+    const auto& t = m_counter_thresholds;
+
+    if (is_reached(counters.fullscan_steps, t.fullscan_steps) ||
+        is_reached(counters.sorts, t.sorts) ||
+        is_reached(counters.autoindexes, t.autoindexes) ||
+        is_reached(counters.vm_steps, t.vm_steps))
+    {
+        m_counters_callback(sql, counters);
     }
 }
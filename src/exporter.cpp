@@ -0,0 +1,423 @@
+#include "sqlw/exporter.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+/**
+ * Writes chunks to a file descriptor on its own thread. `submit` hands
+ * over a full chunk and gets back the one written before it, so the
+ * producer and the writer swap buffers instead of allocating.
+ */
+class ChunkWriter
+{
+  public:
+    ChunkWriter(int fd) : m_fd(fd), m_thread([this]() { loop(); })
+    {
+    }
+
+    ~ChunkWriter()
+    {
+        finish();
+    }
+
+    /**
+     * Queues `chunk` for writing and leaves an empty buffer in its place.
+     * Blocks while the previous chunk is still queued.
+     */
+    auto submit(std::string& chunk) -> std::error_code
+    {
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this]() { return !m_has_pending || m_failed; });
+
+        if (m_failed)
+        {
+            return m_status;
+        }
+
+        std::swap(m_pending, chunk);
+        chunk.clear();
+        m_has_pending = true;
+        m_cv.notify_all();
+
+        return m_status;
+    }
+
+    /**
+     * Waits until everything submitted is written.
+     */
+    auto finish() -> std::error_code
+    {
+        {
+            std::lock_guard lock{m_mutex};
+            m_done = true;
+        }
+
+        m_cv.notify_all();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        return m_status;
+    }
+
+  private:
+    const int m_fd;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_pending;
+    bool m_has_pending{false};
+    bool m_done{false};
+    bool m_failed{false};
+    std::error_code m_status{sqlw::status::Code{SQLITE_OK}};
+    std::thread m_thread;
+
+    auto loop() -> void
+    {
+        std::string writing;
+
+        for (;;)
+        {
+            {
+                std::unique_lock lock{m_mutex};
+                m_cv.wait(lock, [this]() { return m_has_pending || m_done; });
+
+                if (!m_has_pending)
+                {
+                    return;
+                }
+
+                std::swap(m_pending, writing);
+                m_has_pending = false;
+            }
+
+            m_cv.notify_all();
+
+            if (const int error = write_all(writing); 0 != error)
+            {
+                std::lock_guard lock{m_mutex};
+                m_status = {error, std::system_category()};
+                m_failed = true;
+                m_cv.notify_all();
+                return;
+            }
+
+            writing.clear();
+        }
+    }
+
+    auto write_all(std::string_view data) noexcept -> int
+    {
+        while (!data.empty())
+        {
+            const auto n = ::write(m_fd, data.data(), data.size());
+
+            if (n < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+
+                return errno;
+            }
+
+            data.remove_prefix(n);
+        }
+
+        return 0;
+    }
+};
+
+template <typename T> auto append_number(std::string& out, T value) -> void
+{
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+auto append_hex(std::string& out, std::string_view data) -> void
+{
+    constexpr std::string_view digits = "0123456789abcdef";
+
+    for (unsigned char c : data)
+    {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0xF]);
+    }
+}
+
+auto append_csv_text(std::string& out, std::string_view text, char delimiter)
+    -> void
+{
+    if (std::string_view::npos == text.find_first_of("\"\r\n") &&
+        std::string_view::npos == text.find(delimiter))
+    {
+        out.append(text);
+        return;
+    }
+
+    out.push_back('"');
+
+    for (char c : text)
+    {
+        out.push_back(c);
+
+        if ('"' == c)
+        {
+            out.push_back('"');
+        }
+    }
+
+    out.push_back('"');
+}
+
+auto append_json_text(std::string& out, std::string_view text) -> void
+{
+    out.push_back('"');
+
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                constexpr std::string_view digits = "0123456789abcdef";
+                out.append("\\u00");
+                out.push_back(digits[c >> 4]);
+                out.push_back(digits[c & 0xF]);
+            }
+            else
+            {
+                out.push_back(c);
+            }
+        }
+    }
+
+    out.push_back('"');
+}
+
+auto column_text(sqlite3_stmt* stmt, int i) -> std::string_view
+{
+    const auto data =
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+    return {data, static_cast<size_t>(sqlite3_column_bytes(stmt, i))};
+}
+
+auto column_blob(sqlite3_stmt* stmt, int i) -> std::string_view
+{
+    const auto data = static_cast<const char*>(sqlite3_column_blob(stmt, i));
+    return {data, static_cast<size_t>(sqlite3_column_bytes(stmt, i))};
+}
+
+auto append_csv_row(std::string& out, sqlite3_stmt* stmt, char delimiter)
+    -> void
+{
+    const int count = sqlite3_column_count(stmt);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (0 != i)
+        {
+            out.push_back(delimiter);
+        }
+
+        switch (sqlite3_column_type(stmt, i))
+        {
+        case SQLITE_INTEGER:
+            append_number(out, sqlite3_column_int64(stmt, i));
+            break;
+        case SQLITE_FLOAT:
+            append_number(out, sqlite3_column_double(stmt, i));
+            break;
+        case SQLITE_TEXT:
+            append_csv_text(out, column_text(stmt, i), delimiter);
+            break;
+        case SQLITE_BLOB:
+            append_hex(out, column_blob(stmt, i));
+            break;
+        }
+    }
+
+    out.push_back('\n');
+}
+
+auto append_json_row(std::string& out, sqlite3_stmt* stmt) -> void
+{
+    const int count = sqlite3_column_count(stmt);
+
+    out.push_back('{');
+
+    for (int i = 0; i < count; i++)
+    {
+        if (0 != i)
+        {
+            out.push_back(',');
+        }
+
+        append_json_text(out, sqlite3_column_name(stmt, i));
+        out.push_back(':');
+
+        switch (sqlite3_column_type(stmt, i))
+        {
+        case SQLITE_INTEGER:
+            append_number(out, sqlite3_column_int64(stmt, i));
+            break;
+        case SQLITE_FLOAT: {
+            const double value = sqlite3_column_double(stmt, i);
+
+            if (std::isfinite(value))
+            {
+                append_number(out, value);
+            }
+            else
+            {
+                out.append("null");
+            }
+
+            break;
+        }
+        case SQLITE_TEXT:
+            append_json_text(out, column_text(stmt, i));
+            break;
+        case SQLITE_BLOB:
+            out.push_back('"');
+            append_hex(out, column_blob(stmt, i));
+            out.push_back('"');
+            break;
+        default:
+            out.append("null");
+        }
+    }
+
+    out.append("}\n");
+}
+} // namespace
+
+sqlw::Exporter::Exporter(
+    sqlw::Connection* connection,
+    sqlw::Exporter::Options options)
+    : m_connection(connection), m_options(options)
+{
+}
+
+std::error_code sqlw::Exporter::run(
+    std::string_view sql,
+    int fd,
+    std::span<const sqlw::Statement::bindable_t> params)
+{
+    m_stats = {};
+
+    Statement stmt{m_connection};
+
+    if (status::Condition::OK != stmt.prepare(sql).status())
+    {
+        return stmt.status();
+    }
+
+    if (!stmt.bind(params).empty() || status::Condition::OK != stmt.status())
+    {
+        return status::Condition::OK != stmt.status()
+                   ? stmt.status()
+                   : status::Code::UNUSED_PARAMETERS_ERROR;
+    }
+
+    sqlite3_stmt* handle = stmt.handle();
+    std::string chunk;
+    chunk.reserve(m_options.chunk_size);
+
+    ChunkWriter writer{fd};
+    std::error_code ec{status::Code{SQLITE_OK}};
+
+    const auto flush = [&]() {
+        m_stats.bytes_written += chunk.size();
+        m_stats.chunks++;
+        ec = writer.submit(chunk);
+    };
+
+    if (Format::CSV == m_options.format && m_options.header)
+    {
+        for (int i = 0; i < sqlite3_column_count(handle); i++)
+        {
+            if (0 != i)
+            {
+                chunk.push_back(m_options.delimiter);
+            }
+
+            append_csv_text(
+                chunk,
+                sqlite3_column_name(handle, i),
+                m_options.delimiter);
+        }
+
+        chunk.push_back('\n');
+    }
+
+    int rc = SQLITE_ROW;
+
+    while (status::Condition::OK == ec &&
+           SQLITE_ROW == (rc = sqlite3_step(handle)))
+    {
+        if (Format::CSV == m_options.format)
+        {
+            append_csv_row(chunk, handle, m_options.delimiter);
+        }
+        else
+        {
+            append_json_row(chunk, handle);
+        }
+
+        m_stats.rows++;
+
+        if (chunk.size() >= m_options.chunk_size)
+        {
+            flush();
+        }
+    }
+
+    if (SQLITE_INTERRUPT == rc)
+    {
+        ec = m_connection->interrupt_status();
+    }
+
+    if (status::Condition::OK == ec && !chunk.empty())
+    {
+        flush();
+    }
+
+    const auto write_status = writer.finish();
+
+    if (status::Condition::OK != write_status)
+    {
+        return write_status;
+    }
+
+    return status::Condition::OK != ec ? ec : status::Code{rc};
+}
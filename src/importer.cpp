@@ -0,0 +1,1182 @@
+#include "sqlw/importer.hpp"
+#include "sqlw/change_feed.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <gsl/util>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+
+namespace
+{
+struct Field
+{
+    sqlw::Type type{sqlw::Type::SQL_NULL};
+    size_t offset{0};
+    size_t size{0};
+    int64_t integer{0};
+    double real{0};
+};
+
+/**
+ * A record. Its raw text stays in the arena for quarantining.
+ */
+struct Row
+{
+    size_t line;
+    size_t raw_offset;
+    size_t raw_size;
+    size_t first_field;
+};
+
+struct Reject
+{
+    size_t line;
+    size_t raw_offset;
+    size_t raw_size;
+};
+
+/**
+ * Parsed records. Fields refer to the arena by offset, so it can grow
+ * while a batch is filled; cleared batches keep their capacity.
+ */
+struct Batch
+{
+    std::string arena;
+    std::vector<Field> fields;
+    std::vector<Row> rows;
+    std::vector<Reject> rejects;
+
+    auto records() const noexcept -> size_t
+    {
+        return rows.size() + rejects.size();
+    }
+
+    auto raw(size_t offset, size_t size) const noexcept -> std::string_view
+    {
+        return {arena.data() + offset, size};
+    }
+
+    auto clear() noexcept -> void
+    {
+        arena.clear();
+        fields.clear();
+        rows.clear();
+        rejects.clear();
+    }
+};
+
+typedef std::unique_ptr<Batch> batch_ptr_t;
+
+/**
+ * Blocking queue of batches, bounded by the number of batches in
+ * circulation. Once closed, `push` drops its argument and `pop` drains
+ * what's left and then returns nullptr.
+ */
+class BatchQueue
+{
+  public:
+    auto push(batch_ptr_t batch) -> void
+    {
+        {
+            std::lock_guard lock{m_mutex};
+
+            if (m_closed)
+            {
+                return;
+            }
+
+            m_batches.push_back(std::move(batch));
+        }
+
+        m_cv.notify_one();
+    }
+
+    auto pop() -> batch_ptr_t
+    {
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this]() { return m_closed || !m_batches.empty(); });
+
+        if (m_batches.empty())
+        {
+            return nullptr;
+        }
+
+        auto batch = std::move(m_batches.front());
+        m_batches.pop_front();
+
+        return batch;
+    }
+
+    auto close() -> void
+    {
+        {
+            std::lock_guard lock{m_mutex};
+            m_closed = true;
+        }
+
+        m_cv.notify_all();
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<batch_ptr_t> m_batches;
+    bool m_closed{false};
+};
+
+auto is_number_start(char c) noexcept -> bool
+{
+    return ('0' <= c && c <= '9') || '-' == c || '.' == c;
+}
+
+/**
+ * Types an unquoted value. Text is referenced at `offset` either way.
+ */
+auto classify(std::string_view value, size_t offset) noexcept -> Field
+{
+    Field f{sqlw::Type::SQL_TEXT, offset, value.size()};
+
+    if (value.empty())
+    {
+        f.type = sqlw::Type::SQL_NULL;
+        return f;
+    }
+
+    if (!is_number_start(value[0]))
+    {
+        return f;
+    }
+
+    const auto end = value.data() + value.size();
+
+    if (auto [p, ec] = std::from_chars(value.data(), end, f.integer);
+        std::errc{} == ec && end == p)
+    {
+        f.type = sqlw::Type::SQL_INT;
+    }
+    else if (auto [q, ec2] = std::from_chars(value.data(), end, f.real);
+             std::errc{} == ec2 && end == q)
+    {
+        f.type = sqlw::Type::SQL_DOUBLE;
+    }
+
+    return f;
+}
+
+/**
+ * Types an unquoted CSV value. Numbers stay TEXT unless they print back
+ * as the same text, so that e.g. `00123`, `1e3` or integers beyond int64
+ * reach TEXT columns unchanged.
+ */
+auto classify_csv(std::string_view value, size_t offset) noexcept -> Field
+{
+    auto f = classify(value, offset);
+    std::array<char, 32> buffer;
+    std::to_chars_result printed{};
+
+    if (sqlw::Type::SQL_INT == f.type)
+    {
+        printed = std::to_chars(
+            buffer.data(),
+            buffer.data() + buffer.size(),
+            f.integer);
+    }
+    else if (sqlw::Type::SQL_DOUBLE == f.type)
+    {
+        printed =
+            std::to_chars(buffer.data(), buffer.data() + buffer.size(), f.real);
+    }
+    else
+    {
+        return f;
+    }
+
+    if (std::errc{} != printed.ec ||
+        value != std::string_view{
+                     buffer.data(),
+                     static_cast<size_t>(printed.ptr - buffer.data())})
+    {
+        f.type = sqlw::Type::SQL_TEXT;
+    }
+
+    return f;
+}
+
+auto append_utf8(std::string& out, uint32_t cp) -> void
+{
+    if (cp < 0x80)
+    {
+        out.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+auto parse_hex4(std::string_view s, size_t pos, uint32_t& cp) noexcept -> bool
+{
+    if (pos + 4 > s.size())
+    {
+        return false;
+    }
+
+    auto [p, ec] = std::from_chars(s.data() + pos, s.data() + pos + 4, cp, 16);
+
+    return std::errc{} == ec && s.data() + pos + 4 == p;
+}
+
+/**
+ * Appends the JSON string body `s` (without quotes) with escapes resolved.
+ */
+auto unescape_json(std::string_view s, std::string& out) -> bool
+{
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if ('\\' != s[i])
+        {
+            out.push_back(s[i]);
+            continue;
+        }
+
+        if (++i == s.size())
+        {
+            return false;
+        }
+
+        switch (s[i])
+        {
+        case '"':
+        case '\\':
+        case '/':
+            out.push_back(s[i]);
+            break;
+        case 'b':
+            out.push_back('\b');
+            break;
+        case 'f':
+            out.push_back('\f');
+            break;
+        case 'n':
+            out.push_back('\n');
+            break;
+        case 'r':
+            out.push_back('\r');
+            break;
+        case 't':
+            out.push_back('\t');
+            break;
+        case 'u': {
+            uint32_t cp = 0;
+
+            if (!parse_hex4(s, i + 1, cp))
+            {
+                return false;
+            }
+
+            i += 4;
+
+            if (0xD800 <= cp && cp < 0xDC00 && i + 2 < s.size() &&
+                '\\' == s[i + 1] && 'u' == s[i + 2])
+            {
+                uint32_t low = 0;
+
+                if (parse_hex4(s, i + 3, low) && 0xDC00 <= low && low < 0xE000)
+                {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+
+            append_utf8(out, cp);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Turns records into rows of a batch. Runs on the parser thread.
+ */
+class Parser
+{
+  public:
+    Parser(
+        const sqlw::Importer::Options& options,
+        std::vector<std::string>& columns)
+        : m_options(options), m_columns(columns),
+          m_field_count(columns.size()),
+          m_expect_header(
+              sqlw::Importer::Format::CSV == options.format && options.header)
+    {
+    }
+
+    auto parse(std::string_view record, size_t line, Batch& batch) -> void
+    {
+        if (sqlw::Importer::Format::CSV == m_options.format)
+        {
+            parse_csv(record, line, batch);
+        }
+        else
+        {
+            parse_json(record, line, batch);
+        }
+    }
+
+    /**
+     * Offset of the newline ending the first record in `data`, or npos if
+     * the record isn't complete yet.
+     */
+    auto record_end(std::string_view data) const noexcept -> size_t
+    {
+        if (sqlw::Importer::Format::NDJSON == m_options.format)
+        {
+            return data.find('\n');
+        }
+
+        bool quoted = false;
+
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            if ('"' == data[i])
+            {
+                quoted = !quoted;
+            }
+            else if ('\n' == data[i] && !quoted)
+            {
+                return i;
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    auto field_count() const noexcept -> size_t
+    {
+        return m_field_count;
+    }
+
+  private:
+    const sqlw::Importer::Options& m_options;
+    std::vector<std::string>& m_columns;
+    size_t m_field_count;
+    bool m_expect_header;
+    std::string m_key;
+
+    auto reject(
+        Batch& batch,
+        size_t line,
+        size_t raw_offset,
+        size_t raw_size,
+        size_t first_field) -> void
+    {
+        batch.fields.resize(first_field);
+        batch.rejects.push_back({line, raw_offset, raw_size});
+    }
+
+    auto parse_csv(std::string_view record, size_t line, Batch& batch) -> void
+    {
+        const size_t raw_offset = batch.arena.size();
+        const size_t first = batch.fields.size();
+        const char delimiter = m_options.delimiter;
+        bool ok = true;
+        size_t pos = 0;
+
+        batch.arena.append(record);
+
+        for (;;)
+        {
+            if (pos < record.size() && '"' == record[pos])
+            {
+                size_t close = pos + 1;
+                bool escaped = false;
+
+                for (;;)
+                {
+                    close = record.find('"', close);
+
+                    if (std::string_view::npos == close ||
+                        close + 1 >= record.size() || '"' != record[close + 1])
+                    {
+                        break;
+                    }
+
+                    escaped = true;
+                    close += 2;
+                }
+
+                if (std::string_view::npos == close)
+                {
+                    ok = false;
+                    break;
+                }
+
+                Field f{
+                    sqlw::Type::SQL_TEXT,
+                    raw_offset + pos + 1,
+                    close - pos - 1};
+
+                if (escaped)
+                {
+                    f.offset = batch.arena.size();
+
+                    for (size_t i = pos + 1; i < close; i++)
+                    {
+                        batch.arena.push_back(record[i]);
+                        i += '"' == record[i] ? 1 : 0;
+                    }
+
+                    f.size = batch.arena.size() - f.offset;
+                }
+
+                batch.fields.push_back(f);
+                pos = close + 1;
+
+                if (pos < record.size() && delimiter != record[pos])
+                {
+                    ok = false;
+                    break;
+                }
+            }
+            else
+            {
+                size_t end = record.find(delimiter, pos);
+                end = std::string_view::npos == end ? record.size() : end;
+
+                batch.fields.push_back(
+                    classify_csv(
+                        record.substr(pos, end - pos),
+                        raw_offset + pos));
+                pos = end;
+            }
+
+            if (pos >= record.size())
+            {
+                break;
+            }
+
+            pos++;
+        }
+
+        const size_t count = batch.fields.size() - first;
+
+        // The header isn't held to the width of explicit columns. Without
+        // them a malformed header is skipped and the next record is taken
+        // as the header instead.
+        if (m_expect_header)
+        {
+            m_expect_header = !ok && m_columns.empty();
+
+            if (!ok)
+            {
+                reject(batch, line, raw_offset, record.size(), first);
+                return;
+            }
+
+            if (m_columns.empty())
+            {
+                for (size_t i = first; i < batch.fields.size(); i++)
+                {
+                    const auto& f = batch.fields[i];
+                    m_columns.emplace_back(batch.raw(f.offset, f.size));
+                }
+
+                m_field_count = count;
+            }
+
+            batch.fields.resize(first);
+            batch.arena.resize(raw_offset);
+            return;
+        }
+
+        if (ok && 0 == m_field_count)
+        {
+            m_field_count = count;
+        }
+
+        if (!ok || count != m_field_count)
+        {
+            reject(batch, line, raw_offset, record.size(), first);
+            return;
+        }
+
+        batch.rows.push_back({line, raw_offset, record.size(), first});
+    }
+
+    auto parse_json(std::string_view record, size_t line, Batch& batch)
+        -> void
+    {
+        const size_t raw_offset = batch.arena.size();
+        const size_t first = batch.fields.size();
+        const bool discover = m_columns.empty();
+
+        batch.arena.append(record);
+
+        if (!discover)
+        {
+            batch.fields.resize(first + m_columns.size());
+        }
+
+        if (!parse_object(record, raw_offset, first, discover, batch))
+        {
+            if (discover)
+            {
+                m_columns.clear();
+            }
+
+            reject(batch, line, raw_offset, record.size(), first);
+            return;
+        }
+
+        if (discover)
+        {
+            m_field_count = m_columns.size();
+        }
+
+        batch.rows.push_back({line, raw_offset, record.size(), first});
+    }
+
+    static auto skip_space(std::string_view s, size_t& pos) noexcept -> void
+    {
+        while (pos < s.size() &&
+               (' ' == s[pos] || '\t' == s[pos] || '\r' == s[pos]))
+        {
+            pos++;
+        }
+    }
+
+    /**
+     * Finds the closing quote of the string starting at `pos`.
+     */
+    static auto string_end(std::string_view s, size_t pos, bool& escaped)
+        -> size_t
+    {
+        escaped = false;
+
+        for (size_t i = pos + 1; i < s.size(); i++)
+        {
+            if ('\\' == s[i])
+            {
+                escaped = true;
+                i++;
+            }
+            else if ('"' == s[i])
+            {
+                return i;
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    /**
+     * Skips a nested object or array starting at `pos`.
+     */
+    static auto composite_end(std::string_view s, size_t pos) -> size_t
+    {
+        int depth = 0;
+
+        for (size_t i = pos; i < s.size(); i++)
+        {
+            bool escaped = false;
+
+            switch (s[i])
+            {
+            case '"':
+                i = string_end(s, i, escaped);
+
+                if (std::string_view::npos == i)
+                {
+                    return i;
+                }
+
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (0 == --depth)
+                {
+                    return i + 1;
+                }
+
+                break;
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    auto parse_value(
+        std::string_view s,
+        size_t& pos,
+        size_t raw_offset,
+        Batch& batch,
+        Field& f) -> bool
+    {
+        if (pos >= s.size())
+        {
+            return false;
+        }
+
+        const char c = s[pos];
+
+        if ('"' == c)
+        {
+            bool escaped = false;
+            const size_t end = string_end(s, pos, escaped);
+
+            if (std::string_view::npos == end)
+            {
+                return false;
+            }
+
+            const auto body = s.substr(pos + 1, end - pos - 1);
+            f = {sqlw::Type::SQL_TEXT, raw_offset + pos + 1, body.size()};
+
+            if (escaped)
+            {
+                f.offset = batch.arena.size();
+
+                if (!unescape_json(body, batch.arena))
+                {
+                    return false;
+                }
+
+                f.size = batch.arena.size() - f.offset;
+            }
+
+            pos = end + 1;
+            return true;
+        }
+
+        if ('{' == c || '[' == c)
+        {
+            const size_t end = composite_end(s, pos);
+
+            if (std::string_view::npos == end)
+            {
+                return false;
+            }
+
+            f = {sqlw::Type::SQL_TEXT, raw_offset + pos, end - pos};
+            pos = end;
+            return true;
+        }
+
+        for (auto [literal, type, value] :
+             {std::tuple{"true", sqlw::Type::SQL_INT, 1},
+              std::tuple{"false", sqlw::Type::SQL_INT, 0},
+              std::tuple{"null", sqlw::Type::SQL_NULL, 0}})
+        {
+            if (s.substr(pos).starts_with(literal))
+            {
+                f = {type, raw_offset + pos, std::strlen(literal), value};
+                pos += f.size;
+                return true;
+            }
+        }
+
+        size_t end = pos;
+
+        while (end < s.size() &&
+               std::string_view{"+-0123456789.eE"}.find(s[end]) !=
+                   std::string_view::npos)
+        {
+            end++;
+        }
+
+        f = classify(s.substr(pos, end - pos), raw_offset + pos);
+        pos = end;
+
+        return sqlw::Type::SQL_INT == f.type ||
+               sqlw::Type::SQL_DOUBLE == f.type;
+    }
+
+    auto parse_object(
+        std::string_view s,
+        size_t raw_offset,
+        size_t first,
+        bool discover,
+        Batch& batch) -> bool
+    {
+        size_t pos = 0;
+        skip_space(s, pos);
+
+        if (pos >= s.size() || '{' != s[pos++])
+        {
+            return false;
+        }
+
+        skip_space(s, pos);
+
+        if (pos < s.size() && '}' == s[pos])
+        {
+            pos++;
+        }
+        else
+        {
+            for (;;)
+            {
+                if (pos >= s.size() || '"' != s[pos])
+                {
+                    return false;
+                }
+
+                bool escaped = false;
+                const size_t key_end = string_end(s, pos, escaped);
+
+                if (std::string_view::npos == key_end)
+                {
+                    return false;
+                }
+
+                std::string_view key = s.substr(pos + 1, key_end - pos - 1);
+
+                if (escaped)
+                {
+                    m_key.clear();
+
+                    if (!unescape_json(key, m_key))
+                    {
+                        return false;
+                    }
+
+                    key = m_key;
+                }
+
+                pos = key_end + 1;
+                skip_space(s, pos);
+
+                if (pos >= s.size() || ':' != s[pos++])
+                {
+                    return false;
+                }
+
+                skip_space(s, pos);
+                Field f{};
+
+                if (!parse_value(s, pos, raw_offset, batch, f))
+                {
+                    return false;
+                }
+
+                if (discover)
+                {
+                    m_columns.emplace_back(key);
+                    batch.fields.push_back(f);
+                }
+                else if (auto it = std::find(
+                             m_columns.begin(), m_columns.end(), key);
+                         it != m_columns.end())
+                {
+                    batch.fields[first + (it - m_columns.begin())] = f;
+                }
+
+                skip_space(s, pos);
+
+                if (pos < s.size() && ',' == s[pos])
+                {
+                    pos++;
+                    skip_space(s, pos);
+                    continue;
+                }
+
+                if (pos < s.size() && '}' == s[pos])
+                {
+                    pos++;
+                    break;
+                }
+
+                return false;
+            }
+        }
+
+        skip_space(s, pos);
+
+        return pos == s.size();
+    }
+};
+
+auto quote_identifier(std::string_view name) -> std::string
+{
+    std::string quoted{'"'};
+
+    for (char c : name)
+    {
+        quoted.push_back(c);
+
+        if ('"' == c)
+        {
+            quoted.push_back('"');
+        }
+    }
+
+    quoted.push_back('"');
+
+    return quoted;
+}
+
+auto insert_sql(
+    std::string_view table,
+    const std::vector<std::string>& columns,
+    size_t field_count) -> std::string
+{
+    std::string sql = "INSERT INTO " + quote_identifier(table);
+
+    if (!columns.empty())
+    {
+        sql += " (";
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            sql += (0 == i ? "" : ", ") + quote_identifier(columns[i]);
+        }
+
+        sql += ")";
+    }
+
+    sql += " VALUES (";
+
+    for (size_t i = 0; i < field_count; i++)
+    {
+        sql += 0 == i ? "?" : ", ?";
+    }
+
+    return sql + ")";
+}
+
+auto bind_field(sqlite3_stmt* stmt, int idx, const Batch& b, const Field& f)
+    -> int
+{
+    switch (f.type)
+    {
+    case sqlw::Type::SQL_INT:
+        return sqlite3_bind_int64(stmt, idx, f.integer);
+    case sqlw::Type::SQL_DOUBLE:
+        return sqlite3_bind_double(stmt, idx, f.real);
+    case sqlw::Type::SQL_TEXT:
+        return sqlite3_bind_text(
+            stmt,
+            idx,
+            b.arena.data() + f.offset,
+            static_cast<int>(f.size),
+            SQLITE_STATIC);
+    default:
+        return sqlite3_bind_null(stmt, idx);
+    }
+}
+
+/**
+ * Reads `fd` chunk by chunk and hands full batches to `filled`.
+ * Stops early once `free` is closed by the writer.
+ */
+auto read_records(
+    int fd,
+    Parser& parser,
+    const sqlw::Importer::Options& options,
+    BatchQueue& free,
+    BatchQueue& filled,
+    std::atomic<uint64_t>& bytes_read) -> std::error_code
+{
+    std::string buffer(std::max(options.chunk_size, size_t{64}), '\0');
+    size_t begin = 0;
+    size_t end = 0;
+    size_t line = 1;
+    bool eof = false;
+    auto batch = free.pop();
+
+    const auto handle = [&](std::string_view record) {
+        const size_t lines = 1 + std::count(record.begin(), record.end(), '\n');
+
+        if (!record.empty() && '\r' == record.back())
+        {
+            record.remove_suffix(1);
+        }
+
+        if (!record.empty())
+        {
+            parser.parse(record, line, *batch);
+        }
+
+        line += lines;
+
+        if (batch->records() >= options.batch_size)
+        {
+            filled.push(std::move(batch));
+            batch = free.pop();
+        }
+    };
+
+    while (nullptr != batch)
+    {
+        for (;;)
+        {
+            const std::string_view data{buffer.data() + begin, end - begin};
+            const size_t n = parser.record_end(data);
+
+            if (std::string_view::npos == n)
+            {
+                break;
+            }
+
+            begin += n + 1;
+            handle(data.substr(0, n));
+
+            if (nullptr == batch)
+            {
+                return sqlw::status::Code{SQLITE_OK};
+            }
+        }
+
+        if (eof)
+        {
+            if (begin < end)
+            {
+                handle({buffer.data() + begin, end - begin});
+            }
+
+            break;
+        }
+
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+
+        if (end == buffer.size())
+        {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        const auto n = ::read(fd, buffer.data() + end, buffer.size() - end);
+
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            return {errno, std::system_category()};
+        }
+
+        eof = 0 == n;
+        end += n;
+        bytes_read.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    if (nullptr != batch && batch->records() > 0)
+    {
+        filled.push(std::move(batch));
+    }
+
+    return sqlw::status::Code{SQLITE_OK};
+}
+} // namespace
+
+double sqlw::Importer::Stats::rows_per_second() const noexcept
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return 0 == seconds ? 0.0 : rows_imported / seconds;
+}
+
+double sqlw::Importer::Stats::bytes_per_second() const noexcept
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return 0 == seconds ? 0.0 : bytes_read / seconds;
+}
+
+sqlw::Importer::Importer(
+    sqlw::Connection* connection,
+    std::string_view table,
+    sqlw::Importer::Options options)
+    : m_connection(connection), m_table(table), m_options(std::move(options))
+{
+}
+
+std::error_code sqlw::Importer::run(int fd)
+{
+    const auto started = std::chrono::steady_clock::now();
+    sqlite3* db = m_connection->handle();
+    std::vector<std::string> columns = m_options.columns;
+    Parser parser{m_options, columns};
+    BatchQueue free;
+    BatchQueue filled;
+    std::atomic<uint64_t> bytes_read{0};
+    std::error_code read_status{status::Code{SQLITE_OK}};
+    std::error_code ec{status::Code{SQLITE_OK}};
+
+    m_stats = {};
+
+    for (size_t i = 0; i < std::max(m_options.queue_depth, size_t{1}); i++)
+    {
+        free.push(std::make_unique<Batch>());
+    }
+
+    std::jthread reader{[&]() {
+        read_status =
+            read_records(fd, parser, m_options, free, filled, bytes_read);
+        filled.close();
+    }};
+
+    // Unblocks the reader if a callback throws.
+    const auto stop_reader = gsl::finally([&]() { free.close(); });
+
+    std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)> stmt{
+        nullptr,
+        sqlite3_finalize};
+
+    const auto quarantine = [&](size_t line, std::string_view record, int rc) {
+        m_stats.rows_quarantined++;
+
+        if (m_quarantine)
+        {
+            m_quarantine(line, record, status::Code{rc});
+        }
+    };
+
+    while (auto batch = filled.pop())
+    {
+        // The parser settles the columns before its first batch is queued.
+        if (nullptr == stmt && !batch->rows.empty())
+        {
+            const auto sql = insert_sql(m_table, columns, parser.field_count());
+            sqlite3_stmt* raw = nullptr;
+            const int rc =
+                sqlite3_prepare_v2(db, sql.c_str(), -1, &raw, nullptr);
+            stmt.reset(raw);
+
+            if (SQLITE_OK != rc)
+            {
+                ec = status::Code{rc};
+                break;
+            }
+        }
+
+        for (const auto& r : batch->rejects)
+        {
+            quarantine(
+                r.line,
+                batch->raw(r.raw_offset, r.raw_size),
+                static_cast<int>(status::Code::PARSE_ERROR));
+        }
+
+        if (!batch->rows.empty())
+        {
+            int rc = sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
+            uint64_t imported = 0;
+
+            for (size_t i = 0; SQLITE_OK == rc && i < batch->rows.size(); i++)
+            {
+                const auto& row = batch->rows[i];
+
+                for (size_t j = 0; j < parser.field_count(); j++)
+                {
+                    bind_field(
+                        stmt.get(),
+                        static_cast<int>(j + 1),
+                        *batch,
+                        batch->fields[row.first_field + j]);
+                }
+
+                const int step_rc = sqlite3_step(stmt.get());
+                sqlite3_reset(stmt.get());
+
+                if (SQLITE_DONE == step_rc)
+                {
+                    imported++;
+                }
+                else if (
+                    SQLITE_INTERRUPT == step_rc ||
+                    0 != sqlite3_get_autocommit(db))
+                {
+                    // A cancellation stops the import; other errors that
+                    // roll the whole transaction back do so too.
+                    rc = step_rc;
+                }
+                else
+                {
+                    quarantine(
+                        row.line,
+                        batch->raw(row.raw_offset, row.raw_size),
+                        step_rc);
+                }
+            }
+
+            if (SQLITE_OK == rc)
+            {
+                rc = sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+            }
+
+            if (SQLITE_OK != rc)
+            {
+                if (0 == sqlite3_get_autocommit(db))
+                {
+                    sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+                }
+
+                ec = SQLITE_INTERRUPT == rc ? m_connection->interrupt_status()
+                                            : status::Code{rc};
+                break;
+            }
+
+            if (nullptr != m_connection->change_feed())
+            {
+                m_connection->change_feed()->publish(m_connection);
+            }
+
+            m_stats.rows_imported += imported;
+        }
+
+        m_stats.batches++;
+        m_stats.bytes_read = bytes_read.load(std::memory_order_relaxed);
+        m_stats.elapsed = std::chrono::steady_clock::now() - started;
+
+        if (m_progress)
+        {
+            m_progress(m_stats);
+        }
+
+        batch->clear();
+        free.push(std::move(batch));
+    }
+
+    free.close();
+    reader.join();
+
+    m_stats.bytes_read = bytes_read.load(std::memory_order_relaxed);
+    m_stats.elapsed = std::chrono::steady_clock::now() - started;
+
+    return status::Condition::OK != ec ? ec : read_status;
+}
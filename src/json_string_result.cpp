@@ -12,20 +12,21 @@ static bool should_be_quoted(const std::string_view& value)
 {
     return !(
         value.length() > 0 &&
-        (sqlw::is_numeric(value) || is_json_array(value)));
+        (sqlw::utils::is_numeric(value) || is_json_array(value)));
 }
 
-static void close_braces_if_needed(std::stringstream& stream)
+static void close_braces_if_needed(std::pmr::string& buffer)
 {
-    if (stream.view().length() > 0 && stream.view().starts_with('{') &&
-        !stream.view().ends_with('}'))
+    if (buffer.length() > 0 && buffer.starts_with('{') &&
+        !buffer.ends_with('}'))
     {
-        stream << "}";
+        buffer += '}';
     }
 }
 
 sqlw::JsonStringResult::JsonStringResult(
     sqlw::JsonStringResult&& other) noexcept
+    : m_buffer(other.m_buffer.get_allocator())
 {
     *this = std::move(other);
 }
@@ -35,7 +36,7 @@ sqlw::JsonStringResult& sqlw::JsonStringResult::operator=(
 {
     if (this != &other)
     {
-        m_stream = std::move(other.m_stream);
+        m_buffer = std::move(other.m_buffer);
     }
 
     return *this;
@@ -48,20 +49,22 @@ int sqlw::JsonStringResult::callback(
     char** col_name)
 {
     int i;
-    const auto stream = &static_cast<JsonStringResult*>(obj)->m_stream;
+    auto& buffer = static_cast<JsonStringResult*>(obj)->m_buffer;
 
-    if (stream->rdbuf()->in_avail() > 0)
+    if (!buffer.empty())
     {
-        *stream << "},{";
+        buffer += "},{";
     }
     else
     {
-        *stream << "{";
+        buffer += '{';
     }
 
     for (i = 0; i < argc; i++)
     {
-        *stream << '"' << col_name[i] << "\":";
+        buffer += '"';
+        buffer += col_name[i];
+        buffer += "\":";
 
         if (argv[i])
         {
@@ -69,57 +72,77 @@ int sqlw::JsonStringResult::callback(
 
             if (should_be_quoted(value))
             {
-                *stream << '\"' << value << '\"';
+                buffer += '\"';
+                buffer += value;
+                buffer += '\"';
             }
             else
             {
-                *stream << value;
+                buffer += value;
             }
 
             if (i + 1 < argc)
             {
-                *stream << ',';
+                buffer += ',';
             }
         }
         else
         {
-            *stream << "null";
+            buffer += "null";
         }
     }
 
     return 0;
 }
 
-std::string sqlw::JsonStringResult::get_array_result()
+std::string_view sqlw::JsonStringResult::array_result()
 {
-    close_braces_if_needed(m_stream);
+    close_braces_if_needed(m_buffer);
+
+    m_buffer.insert(m_buffer.begin(), '[');
+    m_buffer += ']';
 
-    m_stream << "]";
-    std::stringstream tmp;
-    tmp << "[";
+    return m_buffer;
+}
 
-    tmp << m_stream.rdbuf();
-    m_stream = std::move(tmp);
+std::string_view sqlw::JsonStringResult::object_result()
+{
+    close_braces_if_needed(m_buffer);
 
-    return m_stream.str();
+    return m_buffer;
+}
+
+std::string sqlw::JsonStringResult::get_array_result()
+{
+    return std::string{array_result()};
+}
+
+std::pmr::string sqlw::JsonStringResult::get_array_result(
+    std::pmr::memory_resource* resource)
+{
+    return std::pmr::string{array_result(), resource};
 }
 
 std::string sqlw::JsonStringResult::get_object_result()
 {
-    close_braces_if_needed(m_stream);
+    return std::string{object_result()};
+}
 
-    return m_stream.str();
+std::pmr::string sqlw::JsonStringResult::get_object_result(
+    std::pmr::memory_resource* resource)
+{
+    return std::pmr::string{object_result(), resource};
 }
 
 void sqlw::JsonStringResult::row(int column_count)
 {
-    if (m_stream.rdbuf()->in_avail() > 0)
+    if (!m_buffer.empty())
     {
-        m_stream << "},{";
+        m_buffer += "},{";
     }
     else
     {
-        m_stream << "{";
+        m_buffer += '{';
     }
 }
 
@@ -128,28 +151,32 @@ void sqlw::JsonStringResult::column(
     sqlw::Type type,
     std::string_view value)
 {
-    if (!m_stream.view().ends_with('{'))
+    if (!m_buffer.ends_with('{'))
     {
-        m_stream << ',';
+        m_buffer += ',';
     }
 
-    m_stream << '"' << name << "\":";
+    m_buffer += '"';
+    m_buffer += name;
+    m_buffer += "\":";
 
     if (sqlw::Type::SQL_NULL == type)
     {
-        m_stream << "null";
+        m_buffer += "null";
     }
     else if (should_be_quoted(value))
     {
-        m_stream << '\"' << value << '\"';
+        m_buffer += '\"';
+        m_buffer += value;
+        m_buffer += '\"';
     }
     else
     {
-        m_stream << value;
+        m_buffer += value;
     }
 }
 
 bool sqlw::JsonStringResult::has_result()
 {
-    return m_stream.rdbuf()->in_avail() > 0;
+    return !m_buffer.empty();
 }
@@ -0,0 +1,470 @@
+#include "sqlw/memory.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+constexpr size_t HEADER_SIZE = 8;
+constexpr size_t MIN_CLASS_SIZE = 16;
+constexpr size_t CLASSES = 9;
+constexpr size_t MAX_CLASS_SIZE = MIN_CLASS_SIZE << (CLASSES - 1);
+constexpr size_t SLAB_SIZE = 64 * 1024;
+
+/**
+ * Number of blocks moved between a thread cache and the shared free list
+ * at once.
+ */
+constexpr uint32_t BATCH = 32;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct SizeClass
+{
+    std::mutex mutex;
+    FreeBlock* head{nullptr};
+};
+
+struct Pool
+{
+    std::array<SizeClass, CLASSES> classes;
+    std::atomic<uint64_t> pooled_allocations{0};
+    std::atomic<uint64_t> large_allocations{0};
+    std::atomic<uint64_t> slab_bytes{0};
+};
+
+// Never destroyed: SQLite may free memory during static destruction.
+Pool& pool()
+{
+    static Pool* p = new Pool;
+    return *p;
+}
+
+auto class_of(size_t size) noexcept -> size_t
+{
+    size_t c = 0;
+
+    while ((MIN_CLASS_SIZE << c) < size)
+    {
+        c++;
+    }
+
+    return c;
+}
+
+auto class_size(size_t c) noexcept -> size_t
+{
+    return MIN_CLASS_SIZE << c;
+}
+
+auto header(void* p) noexcept -> uint64_t*
+{
+    return reinterpret_cast<uint64_t*>(static_cast<char*>(p) - HEADER_SIZE);
+}
+
+auto payload(void* block) noexcept -> void*
+{
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+/**
+ * Moves up to `count` blocks of class `c` from the shared free list into
+ * `head`, carving a new slab if the list is empty.
+ */
+auto refill(size_t c, FreeBlock*& head, uint32_t count) noexcept -> uint32_t
+{
+    auto& size_class = pool().classes[c];
+    std::lock_guard lock{size_class.mutex};
+
+    if (nullptr == size_class.head)
+    {
+        const size_t block_size = HEADER_SIZE + class_size(c);
+        auto slab = static_cast<char*>(std::malloc(SLAB_SIZE));
+
+        if (nullptr == slab)
+        {
+            return 0;
+        }
+
+        pool().slab_bytes.fetch_add(SLAB_SIZE, std::memory_order_relaxed);
+
+        for (size_t offset = 0; offset + block_size <= SLAB_SIZE;
+             offset += block_size)
+        {
+            auto block = reinterpret_cast<FreeBlock*>(slab + offset);
+            block->next = size_class.head;
+            size_class.head = block;
+        }
+    }
+
+    uint32_t moved = 0;
+
+    while (moved < count && nullptr != size_class.head)
+    {
+        auto block = size_class.head;
+        size_class.head = block->next;
+        block->next = head;
+        head = block;
+        moved++;
+    }
+
+    return moved;
+}
+
+auto give_back(size_t c, FreeBlock*& head, uint32_t count) noexcept -> void
+{
+    auto& size_class = pool().classes[c];
+    std::lock_guard lock{size_class.mutex};
+
+    for (uint32_t i = 0; i < count && nullptr != head; i++)
+    {
+        auto block = head;
+        head = block->next;
+        block->next = size_class.head;
+        size_class.head = block;
+    }
+}
+
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache
+{
+    std::array<FreeBlock*, CLASSES> heads{};
+    std::array<uint32_t, CLASSES> counts{};
+
+    ~ThreadCache()
+    {
+        thread_cache_destroyed = true;
+
+        for (size_t c = 0; c < CLASSES; c++)
+        {
+            give_back(c, heads[c], counts[c]);
+        }
+    }
+};
+
+thread_local ThreadCache thread_cache;
+
+auto pool_malloc(int n) noexcept -> void*
+{
+    const auto size = static_cast<size_t>(std::max(n, 1));
+
+    if (size > MAX_CLASS_SIZE)
+    {
+        const size_t rounded = (size + 7) & ~size_t{7};
+        auto block = std::malloc(HEADER_SIZE + rounded);
+
+        if (nullptr == block)
+        {
+            return nullptr;
+        }
+
+        *static_cast<uint64_t*>(block) = rounded;
+        pool().large_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        return payload(block);
+    }
+
+    const size_t c = class_of(size);
+    FreeBlock* block = nullptr;
+
+    if (thread_cache_destroyed)
+    {
+        if (1 != refill(c, block, 1))
+        {
+            return nullptr;
+        }
+    }
+    else
+    {
+        auto& head = thread_cache.heads[c];
+
+        if (nullptr == head)
+        {
+            thread_cache.counts[c] += refill(c, head, BATCH);
+
+            if (nullptr == head)
+            {
+                return nullptr;
+            }
+        }
+
+        block = head;
+        head = block->next;
+        thread_cache.counts[c]--;
+    }
+
+    *reinterpret_cast<uint64_t*>(block) = class_size(c);
+    pool().pooled_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return payload(block);
+}
+
+auto pool_free(void* p) noexcept -> void
+{
+    if (nullptr == p)
+    {
+        return;
+    }
+
+    const auto size = *header(p);
+    auto block = reinterpret_cast<FreeBlock*>(header(p));
+
+    if (size > MAX_CLASS_SIZE)
+    {
+        std::free(block);
+        return;
+    }
+
+    const size_t c = class_of(size);
+
+    if (thread_cache_destroyed)
+    {
+        block->next = nullptr;
+        give_back(c, block, 1);
+        return;
+    }
+
+    block->next = thread_cache.heads[c];
+    thread_cache.heads[c] = block;
+    thread_cache.counts[c]++;
+
+    if (thread_cache.counts[c] > 2 * BATCH)
+    {
+        give_back(c, thread_cache.heads[c], BATCH);
+        thread_cache.counts[c] -= BATCH;
+    }
+}
+
+auto pool_size(void* p) noexcept -> int
+{
+    return nullptr == p ? 0 : static_cast<int>(*header(p));
+}
+
+auto pool_roundup(int n) noexcept -> int
+{
+    const auto size = static_cast<size_t>(std::max(n, 1));
+
+    if (size > MAX_CLASS_SIZE)
+    {
+        return static_cast<int>((size + 7) & ~size_t{7});
+    }
+
+    return static_cast<int>(class_size(class_of(size)));
+}
+
+auto pool_realloc(void* p, int n) noexcept -> void*
+{
+    const auto old_size = static_cast<size_t>(pool_size(p));
+    const auto new_size = static_cast<size_t>(pool_roundup(n));
+
+    if (new_size == old_size)
+    {
+        return p;
+    }
+
+    if (old_size > MAX_CLASS_SIZE && new_size > MAX_CLASS_SIZE)
+    {
+        auto block = std::realloc(header(p), HEADER_SIZE + new_size);
+
+        if (nullptr == block)
+        {
+            return nullptr;
+        }
+
+        *static_cast<uint64_t*>(block) = new_size;
+
+        return payload(block);
+    }
+
+    auto q = pool_malloc(n);
+
+    if (nullptr != q)
+    {
+        std::memcpy(q, p, std::min(old_size, new_size));
+        pool_free(p);
+    }
+
+    return q;
+}
+
+auto pool_init(void*) noexcept -> int
+{
+    return SQLITE_OK;
+}
+
+auto pool_shutdown(void*) noexcept -> void
+{
+}
+
+const sqlite3_mem_methods pool_mem_methods{
+    .xMalloc = pool_malloc,
+    .xFree = pool_free,
+    .xRealloc = pool_realloc,
+    .xSize = pool_size,
+    .xRoundup = pool_roundup,
+    .xInit = pool_init,
+    .xShutdown = pool_shutdown,
+    .pAppData = nullptr,
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<sqlite3*> connections;
+};
+
+Registry& registry()
+{
+    static Registry* r = new Registry;
+    return *r;
+}
+} // namespace
+
+std::error_code sqlw::memory::use_pool_allocator() noexcept
+{
+    return status::Code{
+        sqlite3_config(SQLITE_CONFIG_MALLOC, &pool_mem_methods)};
+}
+
+std::error_code sqlw::memory::use_heap(
+    std::span<std::byte> buffer,
+    int min_allocation) noexcept
+{
+    return status::Code{sqlite3_config(
+        SQLITE_CONFIG_HEAP,
+        buffer.data(),
+        static_cast<int>(buffer.size()),
+        min_allocation)};
+}
+
+std::error_code sqlw::memory::use_page_cache(
+    std::span<std::byte> buffer,
+    int page_size) noexcept
+{
+    int header_size = 0;
+    const int rc = sqlite3_config(SQLITE_CONFIG_PCACHE_HDRSZ, &header_size);
+
+    if (SQLITE_OK != rc)
+    {
+        return status::Code{rc};
+    }
+
+    const int slot_size = page_size + header_size;
+    const auto slots = static_cast<int>(buffer.size() / slot_size);
+
+    return status::Code{sqlite3_config(
+        SQLITE_CONFIG_PAGECACHE,
+        buffer.data(),
+        slot_size,
+        slots)};
+}
+
+std::error_code sqlw::memory::configure_mmap(
+    int64_t default_size,
+    int64_t max_size) noexcept
+{
+    return status::Code{sqlite3_config(
+        SQLITE_CONFIG_MMAP_SIZE,
+        static_cast<sqlite3_int64>(default_size),
+        static_cast<sqlite3_int64>(max_size))};
+}
+
+sqlw::memory::PoolStats sqlw::memory::pool_stats() noexcept
+{
+    return {
+        .pooled_allocations =
+            pool().pooled_allocations.load(std::memory_order_relaxed),
+        .large_allocations =
+            pool().large_allocations.load(std::memory_order_relaxed),
+        .slab_bytes = pool().slab_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+int64_t sqlw::memory::set_soft_heap_limit(int64_t bytes) noexcept
+{
+    return sqlite3_soft_heap_limit64(bytes);
+}
+
+int64_t sqlw::memory::set_hard_heap_limit(int64_t bytes) noexcept
+{
+    return sqlite3_hard_heap_limit64(bytes);
+}
+
+int64_t sqlw::memory::used() noexcept
+{
+    return sqlite3_memory_used();
+}
+
+int64_t sqlw::memory::highwater(bool reset) noexcept
+{
+    return sqlite3_memory_highwater(reset ? 1 : 0);
+}
+
+std::error_code sqlw::memory::release_memory() noexcept
+{
+    int rc = SQLITE_OK;
+    std::lock_guard lock{registry().mutex};
+
+    for (auto handle : registry().connections)
+    {
+        // Without a mutex the connection may be in use on another thread.
+        if (nullptr == sqlite3_db_mutex(handle))
+        {
+            continue;
+        }
+
+        const int r = sqlite3_db_release_memory(handle);
+
+        if (SQLITE_OK != r)
+        {
+            rc = r;
+        }
+    }
+
+    return status::Code{rc};
+}
+
+std::error_code sqlw::memory::release_memory(
+    sqlw::Connection* connection) noexcept
+{
+    return status::Code{sqlite3_db_release_memory(connection->handle())};
+}
+
+size_t sqlw::memory::connection_count() noexcept
+{
+    std::lock_guard lock{registry().mutex};
+
+    return registry().connections.size();
+}
+
+void sqlw::memory::internal::register_connection(sqlite3* handle)
+{
+    std::lock_guard lock{registry().mutex};
+
+    registry().connections.push_back(handle);
+}
+
+void sqlw::memory::internal::unregister_connection(sqlite3* handle)
+{
+    std::lock_guard lock{registry().mutex};
+    auto& connections = registry().connections;
+
+    connections.erase(
+        std::remove(connections.begin(), connections.end(), handle),
+        connections.end());
+}
+
+const sqlite3_mem_methods& sqlw::memory::internal::pool_methods() noexcept
+{
+    return pool_mem_methods;
+}
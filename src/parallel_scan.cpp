@@ -0,0 +1,166 @@
+#include "sqlw/parallel_scan.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <optional>
+#include <string>
+
+sqlw::ParallelScan::ParallelScan(std::string_view file_name, size_t readers)
+    : m_pool(readers)
+{
+    m_connections.reserve(m_pool.size());
+
+    for (size_t i = 0; i < m_pool.size(); i++)
+    {
+        auto& con = m_connections.emplace_back(
+            file_name,
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+
+        if (status::Condition::OK != con.status())
+        {
+            m_status = con.status();
+        }
+    }
+}
+
+std::vector<sqlw::Partition> sqlw::ParallelScan::rowid_partitions(
+    std::string_view table,
+    size_t count)
+{
+    std::string quoted{'"'};
+
+    for (char c : table)
+    {
+        quoted += '"' == c ? std::string{"\"\""} : std::string{c};
+    }
+
+    quoted += '"';
+
+    std::vector<std::tuple<std::optional<int64_t>, std::optional<int64_t>>>
+        bounds;
+    Statement stmt{&m_connections.front()};
+
+    if (status::Condition::OK !=
+            stmt.query_as(
+                "SELECT min(rowid), max(rowid) FROM " + quoted,
+                bounds) ||
+        bounds.empty() || !std::get<0>(bounds[0]))
+    {
+        return {};
+    }
+
+    // Sparse rowids can span more than INT64_MAX, and up to 2^64 values,
+    // so the range is measured as `width` + 1 in wrapping unsigned math.
+    const auto first = static_cast<uint64_t>(*std::get<0>(bounds[0]));
+    const auto width = static_cast<uint64_t>(*std::get<1>(bounds[0])) - first;
+    count = std::max<size_t>(1, count);
+
+    if (count - 1 > width)
+    {
+        count = static_cast<size_t>(width + 1);
+    }
+
+    // (width + 1) = size * count + longer, without computing width + 1.
+    uint64_t size = width / count;
+    uint64_t longer = width % count + 1;
+
+    if (longer == count)
+    {
+        size++;
+        longer = 0;
+    }
+
+    std::vector<Partition> partitions;
+    partitions.reserve(count);
+    uint64_t start = first;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint64_t length = size + (i < longer ? 1 : 0);
+        partitions.push_back(
+            {static_cast<int64_t>(start),
+             static_cast<int64_t>(start + length - 1)});
+        start += length;
+    }
+
+    return partitions;
+}
+
+static std::error_code exec(sqlw::Connection& con, const char* sql) noexcept
+{
+    const int rc = sqlite3_exec(con.handle(), sql, nullptr, nullptr, nullptr);
+
+    if (SQLITE_INTERRUPT == rc)
+    {
+        return con.interrupt_status();
+    }
+
+    return sqlw::status::Code{rc};
+}
+
+std::error_code sqlw::ParallelScan::begin_read()
+{
+    // Reading the schema version opens the read transaction.
+    constexpr auto begin = "BEGIN; PRAGMA schema_version";
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+    auto& leader = m_connections.front();
+
+    if (const auto ec = exec(leader, begin); status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    sqlite3_snapshot* snapshot = nullptr;
+
+    if (SQLITE_OK == sqlite3_snapshot_get(leader.handle(), "main", &snapshot))
+    {
+        std::error_code ec = status::Code{SQLITE_OK};
+
+        for (size_t i = 1;
+             i < m_connections.size() && status::Condition::OK == ec;
+             i++)
+        {
+            ec = exec(m_connections[i], "BEGIN");
+
+            if (status::Condition::OK == ec)
+            {
+                ec = status::Code{sqlite3_snapshot_open(
+                    m_connections[i].handle(),
+                    "main",
+                    snapshot)};
+            }
+        }
+
+        sqlite3_snapshot_free(snapshot);
+
+        return ec;
+    }
+#endif
+
+    for (auto& con : m_connections)
+    {
+        if (0 == sqlite3_get_autocommit(con.handle()))
+        {
+            continue;
+        }
+
+        if (const auto ec = exec(con, begin); status::Condition::OK != ec)
+        {
+            return ec;
+        }
+    }
+
+    return status::Code{SQLITE_OK};
+}
+
+void sqlw::ParallelScan::end_read() noexcept
+{
+    for (auto& con : m_connections)
+    {
+        if (0 == sqlite3_get_autocommit(con.handle()))
+        {
+            exec(con, "COMMIT");
+        }
+    }
+}
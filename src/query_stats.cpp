@@ -0,0 +1,553 @@
+#include "sqlw/query_stats.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <map>
+#include <string>
+#include <utility>
+
+using sqlw::query_stats::internal::AtomicHistogram;
+using sqlw::query_stats::internal::Counters;
+using sqlw::query_stats::internal::Shard;
+
+namespace
+{
+std::atomic<uint64_t> next_query_stats_id{1};
+
+/**
+ * Shard used by the current thread the last time.
+ */
+struct ShardCache
+{
+    uint64_t owner_id{0};
+    Shard* shard{nullptr};
+};
+
+thread_local ShardCache shard_cache;
+
+/**
+ * Rows returned so far by statements running on the current thread.
+ */
+thread_local std::vector<std::pair<sqlite3_stmt*, uint64_t>> pending_rows;
+
+thread_local std::string fingerprint_buffer;
+
+auto fnv1a(std::string_view s) noexcept -> uint64_t
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const char c : s)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+auto is_identifier_char(char c) noexcept -> bool
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+           static_cast<unsigned char>(c) >= 0x80;
+}
+
+auto skip_quoted(std::string_view sql, size_t i, char close) noexcept -> size_t
+{
+    for (i++; i < sql.size(); i++)
+    {
+        if (sql[i] == close)
+        {
+            // Doubled quote is an escaped one.
+            if (close != ']' && i + 1 < sql.size() && sql[i + 1] == close)
+            {
+                i++;
+                continue;
+            }
+
+            return i + 1;
+        }
+    }
+
+    return sql.size();
+}
+
+/**
+ * Whether a `-` following `out` is a sign of a number rather than
+ * a subtraction.
+ */
+auto is_sign_position(const std::string& out) noexcept -> bool
+{
+    const auto last = out.find_last_not_of(' ');
+
+    return last == std::string::npos ||
+           std::string_view{"(,=<>+-*/%|"}.find(out[last]) !=
+               std::string_view::npos;
+}
+
+/**
+ * Appends a placeholder, folding lists like `?, ?, ?` into a single `?`.
+ */
+auto append_placeholder(std::string& out) -> void
+{
+    if (out.ends_with("?, "))
+    {
+        out.resize(out.size() - 2);
+    }
+    else if (out.ends_with("?,"))
+    {
+        out.resize(out.size() - 1);
+    }
+    else
+    {
+        out += '?';
+    }
+}
+
+auto normalize(std::string_view sql, std::string& out) -> void
+{
+    out.clear();
+    bool pending_space = false;
+
+    for (size_t i = 0; i < sql.size();)
+    {
+        const char c = sql[i];
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            pending_space = true;
+            i++;
+            continue;
+        }
+
+        if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-')
+        {
+            const auto eol = sql.find('\n', i);
+            i = eol == std::string_view::npos ? sql.size() : eol;
+            pending_space = true;
+            continue;
+        }
+
+        if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*')
+        {
+            const auto end = sql.find("*/", i + 2);
+            i = end == std::string_view::npos ? sql.size() : end + 2;
+            pending_space = true;
+            continue;
+        }
+
+        if (pending_space && !out.empty())
+        {
+            out += ' ';
+        }
+        pending_space = false;
+
+        if (c == '\'')
+        {
+            i = skip_quoted(sql, i, '\'');
+            append_placeholder(out);
+        }
+        else if (
+            (c == 'x' || c == 'X') && i + 1 < sql.size() && sql[i + 1] == '\'')
+        {
+            i = skip_quoted(sql, i + 1, '\'');
+            append_placeholder(out);
+        }
+        else if (c == '"' || c == '`' || c == '[')
+        {
+            const auto end = skip_quoted(sql, i, c == '[' ? ']' : c);
+            out.append(sql.substr(i, end - i));
+            i = end;
+        }
+        else if (
+            std::isdigit(static_cast<unsigned char>(c)) ||
+            ((c == '.' || (c == '-' && is_sign_position(out))) &&
+             i + 1 < sql.size() &&
+             std::isdigit(static_cast<unsigned char>(sql[i + 1]))))
+        {
+            for (i++; i < sql.size(); i++)
+            {
+                const char n = sql[i];
+                const bool exponent_sign =
+                    (n == '+' || n == '-') &&
+                    (sql[i - 1] == 'e' || sql[i - 1] == 'E');
+
+                if (!is_identifier_char(n) && n != '.' && !exponent_sign)
+                {
+                    break;
+                }
+            }
+
+            append_placeholder(out);
+        }
+        else if (c == '?' || c == ':' || c == '@' || c == '$')
+        {
+            for (i++; i < sql.size() && is_identifier_char(sql[i]); i++)
+            {
+            }
+
+            append_placeholder(out);
+        }
+        else if (is_identifier_char(c))
+        {
+            for (; i < sql.size() && is_identifier_char(sql[i]); i++)
+            {
+                out += static_cast<char>(
+                    std::tolower(static_cast<unsigned char>(sql[i])));
+            }
+        }
+        else
+        {
+            out += c;
+            i++;
+        }
+    }
+
+    while (out.ends_with(';') || out.ends_with(' '))
+    {
+        out.pop_back();
+    }
+}
+
+} // namespace
+
+size_t sqlw::Histogram::bucket_index(uint64_t value) noexcept
+{
+    if (value < SUB_BUCKETS)
+    {
+        return value;
+    }
+
+    const size_t magnitude = std::bit_width(value) - 1;
+    const size_t sub = (value >> (magnitude - SUB_BUCKET_BITS)) &
+                       (SUB_BUCKETS - 1);
+
+    return SUB_BUCKETS + (magnitude - SUB_BUCKET_BITS) * SUB_BUCKETS + sub;
+}
+
+uint64_t sqlw::Histogram::bucket_upper_bound(size_t index) noexcept
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    const size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    const uint64_t lower = (SUB_BUCKETS + sub) << shift;
+
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void sqlw::Histogram::record(uint64_t value) noexcept
+{
+    m_buckets[bucket_index(value)]++;
+    m_count++;
+    m_sum += value;
+    m_max = std::max(m_max, value);
+}
+
+void sqlw::Histogram::merge(const sqlw::Histogram& other) noexcept
+{
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+}
+
+uint64_t sqlw::Histogram::percentile(double percentile) const noexcept
+{
+    if (0 == m_count)
+    {
+        return 0;
+    }
+
+    const auto target = static_cast<uint64_t>(
+        std::max(1.0, percentile / 100.0 * static_cast<double>(m_count)));
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        seen += m_buckets[i];
+
+        if (seen >= target)
+        {
+            return std::min(bucket_upper_bound(i), m_max);
+        }
+    }
+
+    return m_max;
+}
+
+void AtomicHistogram::record(uint64_t value) noexcept
+{
+    buckets[sqlw::Histogram::bucket_index(value)].fetch_add(
+        1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    // Only the owning thread writes, so load+store is enough.
+    if (value > max.load(std::memory_order_relaxed))
+    {
+        max.store(value, std::memory_order_relaxed);
+    }
+}
+
+void AtomicHistogram::add_to(sqlw::Histogram& histogram) const noexcept
+{
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        histogram.m_buckets[i] += buckets[i].load(std::memory_order_relaxed);
+    }
+
+    histogram.m_count += count.load(std::memory_order_relaxed);
+    histogram.m_sum += sum.load(std::memory_order_relaxed);
+    histogram.m_max =
+        std::max(histogram.m_max, max.load(std::memory_order_relaxed));
+}
+
+void AtomicHistogram::reset() noexcept
+{
+    for (auto& b : buckets)
+    {
+        b.store(0, std::memory_order_relaxed);
+    }
+
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+sqlw::QueryStats::QueryStats() : m_id(next_query_stats_id.fetch_add(1))
+{
+}
+
+std::error_code sqlw::QueryStats::attach(sqlw::Connection* connection) noexcept
+{
+    if (nullptr == connection->handle())
+    {
+        return status::Code::CLOSED_HANDLE;
+    }
+
+    const auto rc = sqlite3_trace_v2(
+        connection->handle(),
+        SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE,
+        &QueryStats::trace,
+        this);
+
+    if (SQLITE_OK == rc)
+    {
+        connection->m_query_stats = this;
+    }
+
+    return status::Code{rc};
+}
+
+void sqlw::QueryStats::detach(sqlw::Connection* connection) noexcept
+{
+    if (connection->m_query_stats != this)
+    {
+        return;
+    }
+
+    if (nullptr != connection->handle())
+    {
+        sqlite3_trace_v2(connection->handle(), 0, nullptr, nullptr);
+    }
+
+    connection->m_query_stats = nullptr;
+}
+
+int sqlw::QueryStats::trace(unsigned type, void* ctx, void* p, void* x)
+{
+    const auto stats = static_cast<QueryStats*>(ctx);
+    const auto stmt = static_cast<sqlite3_stmt*>(p);
+
+    auto pending = std::find_if(
+        pending_rows.rbegin(), pending_rows.rend(), [&](const auto& entry) {
+            return entry.first == stmt;
+        });
+
+    switch (type)
+    {
+    case SQLITE_TRACE_STMT:
+        // Trigger programs are reported as "-- trigger_name".
+        if (std::string_view{static_cast<const char*>(x)}.starts_with("--"))
+        {
+            break;
+        }
+
+        if (pending == pending_rows.rend())
+        {
+            pending_rows.emplace_back(stmt, 0);
+        }
+        else
+        {
+            pending->second = 0;
+        }
+        break;
+    case SQLITE_TRACE_ROW:
+        if (pending != pending_rows.rend())
+        {
+            pending->second++;
+        }
+        break;
+    case SQLITE_TRACE_PROFILE: {
+        uint64_t rows = 0;
+
+        if (pending != pending_rows.rend())
+        {
+            rows = pending->second;
+            pending_rows.erase(std::next(pending).base());
+        }
+
+        const char* sql = sqlite3_sql(stmt);
+
+        if (nullptr != sql)
+        {
+            stats->record_step(sql, *static_cast<sqlite3_int64*>(x), rows);
+        }
+        break;
+    }
+    }
+
+    return 0;
+}
+
+Shard& sqlw::QueryStats::shard() noexcept
+{
+    if (shard_cache.owner_id == m_id)
+    {
+        return *shard_cache.shard;
+    }
+
+    std::lock_guard lock{m_mutex};
+    auto& shard = m_shards[std::this_thread::get_id()];
+
+    if (nullptr == shard)
+    {
+        shard = std::make_unique<Shard>();
+    }
+
+    shard_cache = {m_id, shard.get()};
+
+    return *shard;
+}
+
+Counters* sqlw::QueryStats::counters(std::string_view sql) noexcept
+{
+    normalize(sql, fingerprint_buffer);
+
+    const auto hash = fnv1a(fingerprint_buffer);
+    auto& s = shard();
+
+    // Only this thread modifies the shard's map, so lookups are lock-free.
+    const auto it = s.entries.find(hash);
+
+    if (it != s.entries.end())
+    {
+        return it->second.get();
+    }
+
+    auto counters = std::make_unique<Counters>();
+    counters->fingerprint = fingerprint_buffer;
+
+    std::lock_guard lock{s.mutex};
+
+    return s.entries.emplace(hash, std::move(counters)).first->second.get();
+}
+
+void sqlw::QueryStats::record_prepare(
+    std::string_view sql,
+    uint64_t ns) noexcept
+{
+    counters(sql)->prepare_ns.record(ns);
+}
+
+void sqlw::QueryStats::record_step(
+    std::string_view sql,
+    uint64_t ns,
+    uint64_t rows) noexcept
+{
+    auto c = counters(sql);
+
+    c->calls.fetch_add(1, std::memory_order_relaxed);
+    c->rows.fetch_add(rows, std::memory_order_relaxed);
+    c->step_ns.record(ns);
+}
+
+std::vector<sqlw::QueryStats::Entry> sqlw::QueryStats::snapshot() const
+{
+    std::map<uint64_t, Entry> merged;
+
+    {
+        std::lock_guard lock{m_mutex};
+
+        for (const auto& [_, shard] : m_shards)
+        {
+            std::lock_guard shard_lock{shard->mutex};
+
+            for (const auto& [hash, c] : shard->entries)
+            {
+                auto [it, inserted] = merged.try_emplace(hash);
+                auto& entry = it->second;
+
+                if (inserted)
+                {
+                    entry.fingerprint = c->fingerprint;
+                }
+
+                entry.calls += c->calls.load(std::memory_order_relaxed);
+                entry.rows += c->rows.load(std::memory_order_relaxed);
+                c->prepare_ns.add_to(entry.prepare_ns);
+                c->step_ns.add_to(entry.step_ns);
+            }
+        }
+    }
+
+    std::vector<Entry> result;
+    result.reserve(merged.size());
+
+    for (auto& [_, entry] : merged)
+    {
+        result.push_back(std::move(entry));
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.prepare_ns.sum() + a.step_ns.sum() >
+               b.prepare_ns.sum() + b.step_ns.sum();
+    });
+
+    return result;
+}
+
+void sqlw::QueryStats::reset() noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    for (const auto& [_, shard] : m_shards)
+    {
+        std::lock_guard shard_lock{shard->mutex};
+
+        for (const auto& [hash, c] : shard->entries)
+        {
+            c->calls.store(0, std::memory_order_relaxed);
+            c->rows.store(0, std::memory_order_relaxed);
+            c->prepare_ns.reset();
+            c->step_ns.reset();
+        }
+    }
+}
+
+std::string sqlw::QueryStats::fingerprint(std::string_view sql)
+{
+    std::string result;
+    normalize(sql, result);
+
+    return result;
+}
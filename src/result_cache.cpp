@@ -0,0 +1,245 @@
+#include "sqlw/result_cache.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <iterator>
+#include <string>
+#include <utility>
+
+namespace
+{
+/**
+ * Cache key: the SQL followed by the type, size and bytes of every
+ * parameter, so that different parameter lists never collide.
+ */
+auto make_key(
+    std::string_view sql,
+    std::span<const sqlw::Statement::bindable_t> params) -> std::string
+{
+    std::string key{sql};
+
+    for (const auto& [value, type] : params)
+    {
+        key.push_back('\0');
+        key.push_back(static_cast<char>(type));
+        key.append(std::to_string(value.size()));
+        key.push_back(':');
+        key.append(value);
+    }
+
+    return key;
+}
+
+auto entry_bytes(
+    std::string_view key,
+    const sqlw::ResultCache::Result& result) noexcept -> size_t
+{
+    return key.size() + result.bytes();
+}
+} // namespace
+
+size_t sqlw::ResultCache::Result::bytes() const noexcept
+{
+    size_t total = sizeof(Result) + m_cells.capacity() * sizeof(Cell) +
+                   m_data.capacity();
+
+    for (const auto& column : m_columns)
+    {
+        total += sizeof(column) + column.capacity();
+    }
+
+    return total;
+}
+
+sqlw::ResultCache::ResultCache(
+    sqlw::Connection* connection,
+    size_t max_bytes)
+    : m_connection(connection), m_max_bytes(max_bytes),
+      m_version_stmt(connection)
+{
+    m_version_stmt.prepare("PRAGMA data_version");
+}
+
+std::error_code sqlw::ResultCache::query(
+    std::string_view sql,
+    std::shared_ptr<const sqlw::ResultCache::Result>& result,
+    std::span<const sqlw::Statement::bindable_t> params)
+{
+    std::string key = make_key(sql, params);
+    const uint64_t current = version();
+
+    if (const auto it = m_index.find(key); it != m_index.end())
+    {
+        if (current == it->second->version)
+        {
+            m_stats.hits++;
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            result = it->second->result;
+
+            return status::Code{SQLITE_DONE};
+        }
+
+        m_stats.stale++;
+        evict(it->second);
+    }
+
+    m_stats.misses++;
+
+    auto fresh = std::make_shared<Result>();
+    bool cacheable = false;
+    const auto ec = execute(sql, params, *fresh, cacheable);
+
+    if (status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    // Reading the version again catches writes made by the query itself.
+    if (cacheable && current == version())
+    {
+        insert(std::move(key), current, fresh);
+    }
+
+    result = std::move(fresh);
+
+    return ec;
+}
+
+void sqlw::ResultCache::clear() noexcept
+{
+    m_index.clear();
+    m_lru.clear();
+    m_stats.entries = 0;
+    m_stats.bytes = 0;
+}
+
+uint64_t sqlw::ResultCache::version() noexcept
+{
+    sqlite3* handle = m_connection->handle();
+    sqlite3_stmt* stmt = m_version_stmt.handle();
+
+    // The step starts a read transaction, which refreshes the pager's
+    // view of commits made by other connections.
+    sqlite3_reset(stmt);
+    sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+
+    unsigned int data_version = 0;
+    sqlite3_file_control(
+        handle,
+        "main",
+        SQLITE_FCNTL_DATA_VERSION,
+        &data_version);
+
+    const auto changes = static_cast<uint64_t>(sqlite3_total_changes64(handle));
+
+    return (changes << 32) ^ data_version;
+}
+
+std::error_code sqlw::ResultCache::execute(
+    std::string_view sql,
+    std::span<const sqlw::Statement::bindable_t> params,
+    sqlw::ResultCache::Result& result,
+    bool& cacheable)
+{
+    Statement stmt{m_connection};
+
+    if (status::Condition::OK != stmt.prepare(sql).status())
+    {
+        return stmt.status();
+    }
+
+    if (!stmt.bind(params).empty() || status::Condition::OK != stmt.status())
+    {
+        return status::Condition::OK != stmt.status()
+                   ? stmt.status()
+                   : status::Code::UNUSED_PARAMETERS_ERROR;
+    }
+
+    sqlite3_stmt* handle = stmt.handle();
+    const int column_count = sqlite3_column_count(handle);
+
+    // BEGIN, COMMIT, SAVEPOINT and RELEASE count as read-only too, but
+    // must run every time; only queries returning rows are kept.
+    cacheable = 0 != sqlite3_stmt_readonly(handle) && column_count > 0;
+
+    for (int i = 0; i < column_count; i++)
+    {
+        result.m_columns.emplace_back(sqlite3_column_name(handle, i));
+    }
+
+    int rc = SQLITE_ROW;
+
+    while (SQLITE_ROW == (rc = sqlite3_step(handle)))
+    {
+        for (int i = 0; i < column_count; i++)
+        {
+            auto& cell = result.m_cells.emplace_back();
+            cell.type = static_cast<Type>(sqlite3_column_type(handle, i));
+            cell.size = 0;
+            cell.integer = 0;
+
+            switch (cell.type)
+            {
+            case Type::SQL_INT:
+                cell.integer = sqlite3_column_int64(handle, i);
+                break;
+            case Type::SQL_DOUBLE:
+                cell.real = sqlite3_column_double(handle, i);
+                break;
+            case Type::SQL_TEXT:
+            case Type::SQL_BLOB: {
+                const auto view = stmt.column_view(cell.type, i);
+                cell.offset = result.m_data.size();
+                cell.size = static_cast<uint32_t>(view.size());
+                result.m_data.append(view);
+                break;
+            }
+            case Type::SQL_NULL:
+                break;
+            }
+        }
+    }
+
+    if (SQLITE_INTERRUPT == rc)
+    {
+        return m_connection->interrupt_status();
+    }
+
+    result.m_cells.shrink_to_fit();
+    result.m_data.shrink_to_fit();
+
+    return status::Code{rc};
+}
+
+void sqlw::ResultCache::insert(
+    std::string key,
+    uint64_t version,
+    std::shared_ptr<const sqlw::ResultCache::Result> result)
+{
+    const size_t bytes = entry_bytes(key, *result);
+
+    if (bytes > m_max_bytes)
+    {
+        return;
+    }
+
+    while (!m_lru.empty() && m_stats.bytes + bytes > m_max_bytes)
+    {
+        m_stats.evictions++;
+        evict(std::prev(m_lru.end()));
+    }
+
+    m_lru.push_front({std::move(key), version, std::move(result)});
+    m_index.emplace(m_lru.front().key, m_lru.begin());
+    m_stats.entries++;
+    m_stats.bytes += bytes;
+}
+
+void sqlw::ResultCache::evict(sqlw::ResultCache::lru_t::iterator it) noexcept
+{
+    m_stats.entries--;
+    m_stats.bytes -= entry_bytes(it->key, *it->result);
+    m_index.erase(it->key);
+    m_lru.erase(it);
+}
@@ -0,0 +1,254 @@
+#include "sqlw/session.hpp"
+
+#ifdef SQLITE_ENABLE_SESSION
+
+#include <cerrno>
+#include <unistd.h>
+
+namespace
+{
+/**
+ * File descriptor a changeset is streamed to or from, with the errno of
+ * the first failed call.
+ */
+struct Stream
+{
+    int fd;
+    int error;
+};
+
+auto append(void* out, const void* data, int size) -> int
+{
+    auto& changeset = *static_cast<std::vector<std::byte>*>(out);
+    const auto* bytes = static_cast<const std::byte*>(data);
+
+    try
+    {
+        changeset.insert(changeset.end(), bytes, bytes + size);
+    }
+    catch (...)
+    {
+        return SQLITE_NOMEM;
+    }
+
+    return SQLITE_OK;
+}
+
+auto write_chunk(void* out, const void* data, int size) -> int
+{
+    auto& stream = *static_cast<Stream*>(out);
+    const auto* bytes = static_cast<const char*>(data);
+
+    while (size > 0)
+    {
+        const auto n = ::write(stream.fd, bytes, static_cast<size_t>(size));
+
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            stream.error = errno;
+            return SQLITE_IOERR_WRITE;
+        }
+
+        bytes += n;
+        size -= static_cast<int>(n);
+    }
+
+    return SQLITE_OK;
+}
+
+auto read_chunk(void* in, void* data, int* size) -> int
+{
+    auto& stream = *static_cast<Stream*>(in);
+
+    for (;;)
+    {
+        const auto n = ::read(stream.fd, data, static_cast<size_t>(*size));
+
+        if (n >= 0)
+        {
+            // Zero marks the end of the input.
+            *size = static_cast<int>(n);
+            return SQLITE_OK;
+        }
+
+        if (EINTR != errno)
+        {
+            stream.error = errno;
+            return SQLITE_IOERR_READ;
+        }
+    }
+}
+
+auto on_conflict(void* policy, int conflict, sqlite3_changeset_iter*) -> int
+{
+    switch (*static_cast<const sqlw::Session::ConflictPolicy*>(policy))
+    {
+    case sqlw::Session::ConflictPolicy::OMIT:
+        return SQLITE_CHANGESET_OMIT;
+    case sqlw::Session::ConflictPolicy::REPLACE:
+        // Only a differing or an existing row can be overwritten.
+        return SQLITE_CHANGESET_DATA == conflict ||
+                       SQLITE_CHANGESET_CONFLICT == conflict
+                   ? SQLITE_CHANGESET_REPLACE
+                   : SQLITE_CHANGESET_OMIT;
+    case sqlw::Session::ConflictPolicy::ABORT:
+        break;
+    }
+
+    return SQLITE_CHANGESET_ABORT;
+}
+
+auto stream_status(int rc, const Stream& stream) -> std::error_code
+{
+    if (0 != stream.error)
+    {
+        return {stream.error, std::system_category()};
+    }
+
+    return sqlw::status::Code{rc};
+}
+} // namespace
+
+sqlw::Session::Session(
+    sqlw::Connection* connection,
+    sqlw::Session::Format format,
+    std::string_view database)
+    : m_connection(connection), m_format(format), m_database(database)
+{
+    m_status = status::Code{sqlite3session_create(
+        m_connection->handle(),
+        m_database.c_str(),
+        &m_session)};
+}
+
+sqlw::Session::~Session()
+{
+    if (nullptr != m_session)
+    {
+        sqlite3session_delete(m_session);
+    }
+}
+
+std::error_code sqlw::Session::attach(std::string_view table)
+{
+    if (status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    std::string name{table};
+    const std::error_code ec = status::Code{sqlite3session_attach(
+        m_session,
+        name.empty() ? nullptr : name.c_str())};
+
+    if (status::Condition::OK == ec)
+    {
+        m_tables.push_back(std::move(name));
+    }
+
+    return ec;
+}
+
+bool sqlw::Session::empty() const noexcept
+{
+    return nullptr == m_session || 0 != sqlite3session_isempty(m_session);
+}
+
+std::error_code sqlw::Session::take(std::vector<std::byte>& changeset)
+{
+    return take(&append, &changeset);
+}
+
+std::error_code sqlw::Session::take(int fd)
+{
+    Stream stream{fd, 0};
+    const auto ec = take(&write_chunk, &stream);
+
+    if (0 != stream.error)
+    {
+        return {stream.error, std::system_category()};
+    }
+
+    return ec;
+}
+
+std::error_code sqlw::Session::take(sqlw::Session::output_t output, void* out)
+{
+    if (status::Condition::OK != m_status)
+    {
+        return m_status;
+    }
+
+    const int rc = Format::PATCHSET == m_format
+                       ? sqlite3session_patchset_strm(m_session, output, out)
+                       : sqlite3session_changeset_strm(m_session, output, out);
+
+    if (SQLITE_OK != rc)
+    {
+        return status::Code{rc};
+    }
+
+    return restart();
+}
+
+std::error_code sqlw::Session::restart()
+{
+    sqlite3session_delete(m_session);
+    m_session = nullptr;
+    m_status = status::Code{sqlite3session_create(
+        m_connection->handle(),
+        m_database.c_str(),
+        &m_session)};
+
+    for (const auto& table : m_tables)
+    {
+        if (status::Condition::OK != m_status)
+        {
+            break;
+        }
+
+        m_status = status::Code{sqlite3session_attach(
+            m_session,
+            table.empty() ? nullptr : table.c_str())};
+    }
+
+    return m_status;
+}
+
+std::error_code sqlw::Session::apply(
+    sqlw::Connection* target,
+    std::span<const std::byte> changeset,
+    sqlw::Session::ConflictPolicy policy)
+{
+    return status::Code{sqlite3changeset_apply(
+        target->handle(),
+        static_cast<int>(changeset.size()),
+        const_cast<std::byte*>(changeset.data()),
+        nullptr,
+        &on_conflict,
+        &policy)};
+}
+
+std::error_code sqlw::Session::apply(
+    sqlw::Connection* target,
+    int fd,
+    sqlw::Session::ConflictPolicy policy)
+{
+    Stream stream{fd, 0};
+    const int rc = sqlite3changeset_apply_strm(
+        target->handle(),
+        &read_chunk,
+        &stream,
+        nullptr,
+        &on_conflict,
+        &policy);
+
+    return stream_status(rc, stream);
+}
+
+#endif // SQLITE_ENABLE_SESSION
@@ -0,0 +1,175 @@
+#include "sqlw/slow_query_log.hpp"
+#include "sqlw/connection.hpp"
+#include <string_view>
+#include <unordered_map>
+
+static std::string_view trim_left(std::string_view sql)
+{
+    const auto start = sql.find_first_not_of(" \t\r\n");
+
+    return start == std::string_view::npos ? "" : sql.substr(start);
+}
+
+static std::vector<std::string> explain_query_plan(sqlite3_stmt* stmt)
+{
+    std::vector<std::string> plan;
+    const char* sql = sqlite3_sql(stmt);
+
+    if (nullptr == sql)
+    {
+        return plan;
+    }
+
+    const std::string eqp = std::string{"EXPLAIN QUERY PLAN "} + sql;
+    sqlite3_stmt* eqp_stmt = nullptr;
+
+    if (SQLITE_OK != sqlite3_prepare_v2(
+                         sqlite3_db_handle(stmt),
+                         eqp.data(),
+                         eqp.size(),
+                         &eqp_stmt,
+                         nullptr))
+    {
+        sqlite3_finalize(eqp_stmt);
+        return plan;
+    }
+
+    std::unordered_map<int, size_t> depth;
+
+    while (SQLITE_ROW == sqlite3_step(eqp_stmt))
+    {
+        const int id = sqlite3_column_int(eqp_stmt, 0);
+        const int parent = sqlite3_column_int(eqp_stmt, 1);
+        const auto detail =
+            reinterpret_cast<const char*>(sqlite3_column_text(eqp_stmt, 3));
+
+        const auto it = depth.find(parent);
+        const size_t level = it == depth.end() ? 0 : it->second + 1;
+        depth[id] = level;
+
+        plan.emplace_back(level * 2, ' ');
+        plan.back() += nullptr == detail ? "" : detail;
+    }
+
+    sqlite3_finalize(eqp_stmt);
+
+    return plan;
+}
+
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+static std::vector<sqlw::SlowQueryLog::ScanStatus> scan_status(
+    sqlite3_stmt* stmt)
+{
+    std::vector<sqlw::SlowQueryLog::ScanStatus> scans;
+
+    for (int i = 0;; i++)
+    {
+        sqlite3_int64 loops = 0;
+
+        if (0 !=
+            sqlite3_stmt_scanstatus(stmt, i, SQLITE_SCANSTAT_NLOOP, &loops))
+        {
+            break;
+        }
+
+        auto& scan = scans.emplace_back();
+        const char* name = nullptr;
+        const char* explain = nullptr;
+
+        scan.loops = loops;
+        sqlite3_stmt_scanstatus(stmt, i, SQLITE_SCANSTAT_NVISIT, &scan.visits);
+        sqlite3_stmt_scanstatus(
+            stmt, i, SQLITE_SCANSTAT_EST, &scan.estimated_rows);
+        sqlite3_stmt_scanstatus(stmt, i, SQLITE_SCANSTAT_NAME, &name);
+        sqlite3_stmt_scanstatus(stmt, i, SQLITE_SCANSTAT_EXPLAIN, &explain);
+
+        scan.name = nullptr == name ? "" : name;
+        scan.explain = nullptr == explain ? "" : explain;
+    }
+
+    return scans;
+}
+#endif
+
+sqlw::SlowQueryLog::SlowQueryLog(
+    std::chrono::nanoseconds threshold,
+    size_t capacity)
+    : m_threshold(threshold), m_entries(capacity)
+{
+}
+
+void sqlw::SlowQueryLog::attach(sqlw::Connection* connection) noexcept
+{
+    connection->m_slow_query_log = this;
+}
+
+void sqlw::SlowQueryLog::detach(sqlw::Connection* connection) noexcept
+{
+    if (connection->m_slow_query_log == this)
+    {
+        connection->m_slow_query_log = nullptr;
+    }
+}
+
+void sqlw::SlowQueryLog::record(
+    sqlite3_stmt* stmt,
+    std::chrono::nanoseconds duration) noexcept
+{
+    if (nullptr == stmt || duration < threshold())
+    {
+        return;
+    }
+
+    try
+    {
+        Entry entry{
+            .logged_at = std::chrono::system_clock::now(),
+            .duration = duration,
+            .parameter_count = sqlite3_bind_parameter_count(stmt),
+        };
+
+        if (const char* sql = sqlite3_sql(stmt))
+        {
+            entry.sql = trim_left(sql);
+        }
+
+        if (char* expanded = sqlite3_expanded_sql(stmt))
+        {
+            entry.expanded_sql = trim_left(expanded).substr(0, max_sql_length);
+            sqlite3_free(expanded);
+        }
+
+        entry.plan = explain_query_plan(stmt);
+
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+        entry.scans = scan_status(stmt);
+#endif
+
+        if (!m_entries.try_push(std::move(entry)))
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    catch (...)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool sqlw::SlowQueryLog::pop(sqlw::SlowQueryLog::Entry& entry) noexcept
+{
+    return m_entries.try_pop(entry);
+}
+
+std::vector<sqlw::SlowQueryLog::Entry> sqlw::SlowQueryLog::drain()
+{
+    std::vector<Entry> entries;
+    Entry entry;
+
+    while (m_entries.try_pop(entry))
+    {
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
@@ -0,0 +1,254 @@
+#include "sqlw/snapshot.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+sqlw::snapshot::Mapping::~Mapping()
+{
+    close();
+}
+
+sqlw::snapshot::Mapping::Mapping(sqlw::snapshot::Mapping&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+sqlw::snapshot::Mapping& sqlw::snapshot::Mapping::operator=(
+    sqlw::snapshot::Mapping&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+
+        m_data = other.m_data;
+        m_size = other.m_size;
+
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    return *this;
+}
+
+std::error_code sqlw::snapshot::Mapping::open(std::string_view path)
+{
+    close();
+
+    const std::string file_name{path};
+    const int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (-1 == fd)
+    {
+        return {errno, std::system_category()};
+    }
+
+    struct stat st = {};
+
+    if (-1 == ::fstat(fd, &st))
+    {
+        const int error = errno;
+        ::close(fd);
+        return {error, std::system_category()};
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+
+    ::close(fd);
+
+    if (MAP_FAILED == data)
+    {
+        return {error, std::system_category()};
+    }
+
+    m_data = data;
+    m_size = size;
+
+    return {};
+}
+
+void sqlw::snapshot::Mapping::close() noexcept
+{
+    if (nullptr != m_data)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+std::error_code sqlw::snapshot::serialize(
+    sqlw::Connection* connection,
+    std::vector<std::byte>& image,
+    std::string_view schema)
+{
+    const std::string schema_name{schema};
+    sqlite3_int64 size = 0;
+
+    // In-memory databases hand out their image without a copy.
+    auto data = sqlite3_serialize(
+        connection->handle(),
+        schema_name.c_str(),
+        &size,
+        SQLITE_SERIALIZE_NOCOPY);
+    const bool owned = nullptr == data;
+
+    if (owned)
+    {
+        data = sqlite3_serialize(
+            connection->handle(),
+            schema_name.c_str(),
+            &size,
+            0);
+    }
+
+    if (nullptr == data)
+    {
+        return status::Code{SQLITE_NOMEM};
+    }
+
+    const auto bytes = reinterpret_cast<const std::byte*>(data);
+    image.assign(bytes, bytes + size);
+
+    if (owned)
+    {
+        sqlite3_free(data);
+    }
+
+    return status::Code{SQLITE_OK};
+}
+
+std::error_code sqlw::snapshot::save(
+    sqlw::Connection* connection,
+    std::string_view path,
+    std::string_view schema)
+{
+    std::vector<std::byte> image;
+
+    if (const auto ec = serialize(connection, image, schema);
+        status::Condition::OK != ec)
+    {
+        return ec;
+    }
+
+    std::ofstream file{std::string{path}, std::ios::binary | std::ios::trunc};
+    file.write(
+        reinterpret_cast<const char*>(image.data()),
+        static_cast<std::streamsize>(image.size()));
+
+    if (!file)
+    {
+        return std::make_error_code(std::errc::io_error);
+    }
+
+    return status::Code{SQLITE_OK};
+}
+
+static std::error_code deserialize(
+    sqlw::Connection* connection,
+    std::string_view schema,
+    unsigned char* data,
+    sqlite3_int64 size,
+    unsigned flags)
+{
+    const std::string schema_name{schema};
+
+    return sqlw::status::Code{sqlite3_deserialize(
+        connection->handle(),
+        schema_name.c_str(),
+        data,
+        size,
+        size,
+        flags)};
+}
+
+std::error_code sqlw::snapshot::load(
+    sqlw::Connection* connection,
+    std::span<const std::byte> image,
+    std::string_view schema)
+{
+    auto data = static_cast<unsigned char*>(sqlite3_malloc64(image.size()));
+
+    if (nullptr == data && !image.empty())
+    {
+        return status::Code{SQLITE_NOMEM};
+    }
+
+    if (!image.empty())
+    {
+        std::memcpy(data, image.data(), image.size());
+    }
+
+    // With FREEONCLOSE SQLite owns `data` even if deserialization fails.
+    return deserialize(
+        connection,
+        schema,
+        data,
+        static_cast<sqlite3_int64>(image.size()),
+        SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+}
+
+std::error_code sqlw::snapshot::load_file(
+    sqlw::Connection* connection,
+    std::string_view path,
+    std::string_view schema)
+{
+    const std::string file_name{path};
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(file_name, ec);
+
+    if (ec)
+    {
+        return ec;
+    }
+
+    std::ifstream file{file_name, std::ios::binary};
+    auto data = static_cast<unsigned char*>(sqlite3_malloc64(size));
+
+    if (nullptr == data && size > 0)
+    {
+        return status::Code{SQLITE_NOMEM};
+    }
+
+    file.read(
+        reinterpret_cast<char*>(data),
+        static_cast<std::streamsize>(size));
+
+    if (!file)
+    {
+        sqlite3_free(data);
+        return std::make_error_code(std::errc::io_error);
+    }
+
+    return deserialize(
+        connection,
+        schema,
+        data,
+        static_cast<sqlite3_int64>(size),
+        SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+}
+
+std::error_code sqlw::snapshot::load_mapped(
+    sqlw::Connection* connection,
+    const sqlw::snapshot::Mapping& mapping,
+    std::string_view schema)
+{
+    const auto image = mapping.data();
+
+    // SQLite never writes to a READONLY image, the cast is safe.
+    return deserialize(
+        connection,
+        schema,
+        reinterpret_cast<unsigned char*>(const_cast<std::byte*>(image.data())),
+        static_cast<sqlite3_int64>(image.size()),
+        SQLITE_DESERIALIZE_READONLY);
+}
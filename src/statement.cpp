@@ -1,23 +1,84 @@
 #include "sqlw/statement.hpp"
+#include "sqlw/array.hpp"
+#include "sqlw/change_feed.hpp"
 #include "sqlw/cmake_vars.h"
 #include "sqlw/connection.hpp"
 #include "sqlw/forward.hpp"
+#include "sqlw/query_stats.hpp"
+#include "sqlw/slow_query_log.hpp"
 #include "sqlw/utils.hpp"
+#include <array>
 #include <charconv>
+#include <chrono>
 #include <cstdlib>
 #include <functional>
-#include <sstream>
+#include <memory_resource>
+#include <new>
 #include <string>
 #include <string_view>
 #include <system_error>
 
+namespace
+{
+/**
+ * Fits any int64 and any double printed with 6 significant digits.
+ */
+typedef std::array<char, 32> number_buffer_t;
+
+/**
+ * Text of a column. Numbers are printed into `buffer` the way a default
+ * `std::ostream` prints them, TEXT and BLOBs are viewed in place.
+ */
+auto column_text(
+    sqlw::Statement& stmt,
+    sqlw::Type type,
+    int column_idx,
+    number_buffer_t& buffer) noexcept -> std::string_view
+{
+    char* const first = buffer.data();
+    char* const last = first + buffer.size();
+    std::to_chars_result result{first, {}};
+
+    switch (type)
+    {
+    case sqlw::Type::SQL_INT:
+        result = std::to_chars(
+            first,
+            last,
+            sqlite3_column_int64(stmt.handle(), column_idx));
+        break;
+    case sqlw::Type::SQL_DOUBLE:
+        result = std::to_chars(
+            first,
+            last,
+            sqlite3_column_double(stmt.handle(), column_idx),
+            std::chars_format::general,
+            6);
+        break;
+    default:
+        return stmt.column_view(type, column_idx);
+    }
+
+    return {first, static_cast<size_t>(result.ptr - first)};
+}
+} // namespace
+
 sqlw::Statement::Statement(sqlw::Connection* con) : m_connection(con)
 {
+    if (nullptr != m_connection)
+    {
+        m_connection->attach(this);
+    }
 }
 
 sqlw::Statement::~Statement()
 {
     sqlite3_finalize(m_stmt);
+
+    if (nullptr != m_connection)
+    {
+        m_connection->detach(this);
+    }
 }
 
 sqlw::Statement::Statement(sqlw::Statement&& other) noexcept
@@ -29,6 +90,18 @@ sqlw::Statement& sqlw::Statement::operator=(sqlw::Statement&& other) noexcept
 {
     if (this != &other)
     {
+        sqlite3_finalize(m_stmt);
+
+        if (nullptr != m_connection)
+        {
+            m_connection->detach(this);
+        }
+
+        if (nullptr != other.m_connection)
+        {
+            other.m_connection->detach(&other);
+        }
+
         m_status = other.m_status;
         m_stmt = other.m_stmt;
         m_connection = other.m_connection;
@@ -39,6 +112,11 @@ sqlw::Statement& sqlw::Statement::operator=(sqlw::Statement&& other) noexcept
         other.m_connection = nullptr;
         other.m_unused_sql = nullptr;
         other.m_status = status::Code::CLOSED_HANDLE;
+
+        if (nullptr != m_connection)
+        {
+            m_connection->attach(this);
+        }
     }
 
     return *this;
@@ -48,7 +126,13 @@ sqlw::Statement& sqlw::Statement::exec(
     sqlw::Statement::callback_t callback) noexcept
 {
     auto rc = sqlite3_step(m_stmt);
-    m_status = status::Code{rc};
+    set_step_status(rc);
+
+    if (SQLITE_ROW != rc)
+    {
+        report_counters();
+        publish_changes();
+    }
 
     if (sqlw::status::Condition::OK != m_status)
     {
@@ -67,18 +151,23 @@ sqlw::Statement& sqlw::Statement::exec(
         return *this;
     }
 
+    if (!callback)
+    {
+        return *this;
+    }
+
+    // Values are views, numbers are printed on the stack.
+    number_buffer_t buffer;
+
     for (auto i = 0; i < col_count; i++)
     {
         const auto t = static_cast<sqlw::Type>(sqlite3_column_type(m_stmt, i));
 
-        if (callback)
-        {
-            callback(
-                {col_count,
-                 sqlite3_column_name(m_stmt, i),
-                 t,
-                 column_value(t, i)});
-        }
+        callback(
+            {col_count,
+             sqlite3_column_name(m_stmt, i),
+             t,
+             column_text(*this, t, i, buffer)});
     }
 
     return *this;
@@ -86,11 +175,35 @@ sqlw::Statement& sqlw::Statement::exec(
 
 sqlw::Statement& sqlw::Statement::prepare(std::string_view sql) noexcept
 {
+    // Re-preparing must not leak the previous statement.
+    sqlite3_finalize(m_stmt);
+    m_stmt = nullptr;
+
+    if (nullptr == m_connection)
+    {
+        m_status = status::Code::CLOSED_HANDLE;
+        return *this;
+    }
+
     m_sql_string = sql;
+    const auto stats = m_connection->query_stats();
+    const auto start = nullptr == stats
+                           ? std::chrono::steady_clock::time_point{}
+                           : std::chrono::steady_clock::now();
+
     auto rc = sqlite3_prepare_v2(
         m_connection->handle(), sql.data(), sql.size(), &m_stmt, &m_unused_sql);
 
-    m_status = status::Code{rc};
+    set_step_status(rc);
+
+    if (nullptr != stats && nullptr != m_stmt)
+    {
+        stats->record_prepare(
+            sqlite3_sql(m_stmt),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
 
     return *this;
 }
@@ -99,6 +212,20 @@ std::error_code sqlw::Statement::operator()(
     sqlw::Statement::callback_t callback,
     sqlw::Statement::unused_params_t unused_params) noexcept
 {
+    const auto slow_query_log =
+        nullptr == m_connection ? nullptr : m_connection->slow_query_log();
+    auto started = nullptr == slow_query_log
+                       ? std::chrono::steady_clock::time_point{}
+                       : std::chrono::steady_clock::now();
+
+    const auto log_if_slow = [&]() {
+        if (nullptr != slow_query_log)
+        {
+            slow_query_log->record(
+                m_stmt, std::chrono::steady_clock::now() - started);
+        }
+    };
+
     size_t iter = 0;
     do
     {
@@ -121,7 +248,7 @@ std::error_code sqlw::Statement::operator()(
                 break;
             }
 
-            sqlite3_finalize(m_stmt);
+            log_if_slow();
             this->prepare(unused);
 
             if (sqlw::status::Condition::OK != m_status)
@@ -129,6 +256,11 @@ std::error_code sqlw::Statement::operator()(
                 break;
             }
 
+            if (nullptr != slow_query_log)
+            {
+                started = std::chrono::steady_clock::now();
+            }
+
             unused_params = this->bind(unused_params);
         }
         else if (sqlw::status::Condition::ROW != m_status)
@@ -137,6 +269,7 @@ std::error_code sqlw::Statement::operator()(
         }
     } while (iter < SQLW_EXEC_LIMIT);
     m_unused_sql = nullptr;
+    log_if_slow();
 
     return m_status;
 }
@@ -284,42 +417,186 @@ sqlw::Statement& sqlw::Statement::bind(int idx, int value) noexcept
     return *this;
 }
 
-std::string sqlw::Statement::column_value(sqlw::Type type, int column_idx)
+sqlw::Statement& sqlw::Statement::bind(int idx, int64_t value) noexcept
 {
-    switch (type)
-    {
-    case sqlw::Type::SQL_INT: {
-        std::ostringstream ss;
+    int rc = sqlite3_bind_int64(m_stmt, idx, value);
 
-        ss << sqlite3_column_int(m_stmt, column_idx);
+    m_status = status::Code{rc};
 
-        return ss.str();
-    }
-    case sqlw::Type::SQL_DOUBLE: {
-        std::ostringstream ss;
+    return *this;
+}
 
-        ss << sqlite3_column_double(m_stmt, column_idx);
+static int bind_array(
+    sqlite3_stmt* stmt,
+    int idx,
+    sqlw::array::ElementType type,
+    const void* data,
+    size_t size) noexcept
+{
+    auto* array = new (std::nothrow) sqlw::array::Array{type, data, size};
 
-        return ss.str();
+    if (nullptr == array)
+    {
+        return SQLITE_NOMEM;
     }
+
+    return sqlite3_bind_pointer(
+        stmt,
+        idx,
+        array,
+        sqlw::array::internal::pointer_type,
+        [](void* p) { delete static_cast<sqlw::array::Array*>(p); });
+}
+
+sqlw::Statement& sqlw::Statement::bind(
+    int idx,
+    std::span<const int64_t> values) noexcept
+{
+    m_status = status::Code{bind_array(
+        m_stmt,
+        idx,
+        array::ElementType::INT64,
+        values.data(),
+        values.size())};
+
+    return *this;
+}
+
+sqlw::Statement& sqlw::Statement::bind(
+    int idx,
+    std::span<const double> values) noexcept
+{
+    m_status = status::Code{bind_array(
+        m_stmt,
+        idx,
+        array::ElementType::DOUBLE,
+        values.data(),
+        values.size())};
+
+    return *this;
+}
+
+sqlw::Statement& sqlw::Statement::bind(
+    int idx,
+    std::span<const std::string_view> values) noexcept
+{
+    m_status = status::Code{bind_array(
+        m_stmt,
+        idx,
+        array::ElementType::TEXT,
+        values.data(),
+        values.size())};
+
+    return *this;
+}
+
+sqlw::Statement& sqlw::Statement::bind_zeroblob(int idx, uint64_t size) noexcept
+{
+    int rc = sqlite3_bind_zeroblob64(m_stmt, idx, size);
+
+    m_status = status::Code{rc};
+
+    return *this;
+}
+
+std::string sqlw::Statement::column_value(sqlw::Type type, int column_idx)
+{
+    number_buffer_t buffer;
+    return std::string{column_text(*this, type, column_idx, buffer)};
+}
+
+std::pmr::string sqlw::Statement::column_value(
+    sqlw::Type type,
+    int column_idx,
+    std::pmr::memory_resource* resource)
+{
+    number_buffer_t buffer;
+    return std::pmr::string{
+        column_text(*this, type, column_idx, buffer),
+        resource};
+}
+
+std::string_view sqlw::Statement::column_view(
+    sqlw::Type type,
+    int column_idx) noexcept
+{
+    switch (type)
+    {
     case sqlw::Type::SQL_TEXT: {
-        const std::string::size_type size =
-            sqlite3_column_bytes(m_stmt, column_idx);
-        return {
-            reinterpret_cast<const char*>(
-                sqlite3_column_text(m_stmt, column_idx)),
-            size};
+        const auto data = reinterpret_cast<const char*>(
+            sqlite3_column_text(m_stmt, column_idx));
+        const auto size = sqlite3_column_bytes(m_stmt, column_idx);
+        return {data, static_cast<size_t>(size)};
     }
     case sqlw::Type::SQL_BLOB: {
-        const std::string::size_type size =
-            sqlite3_column_bytes(m_stmt, column_idx);
-        return {
-            static_cast<const char*>(sqlite3_column_blob(m_stmt, column_idx)),
-            size};
+        const auto data =
+            static_cast<const char*>(sqlite3_column_blob(m_stmt, column_idx));
+        const auto size = sqlite3_column_bytes(m_stmt, column_idx);
+        return {data, static_cast<size_t>(size)};
     }
-    case sqlw::Type::SQL_NULL:
-        return "";
     default:
-        return "";
+        return {};
+    }
+}
+
+sqlw::StatementCounters sqlw::Statement::counters(bool reset) noexcept
+{
+    if (nullptr == m_stmt)
+    {
+        return {};
+    }
+
+    const int r = reset ? 1 : 0;
+
+    return {
+        .fullscan_steps =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, r),
+        .sorts = sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_SORT, r),
+        .autoindexes =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_AUTOINDEX, r),
+        .vm_steps = sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_VM_STEP, r),
+        .reprepares =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_REPREPARE, r),
+        .runs = sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_RUN, r),
+        .filter_misses =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_FILTER_MISS, r),
+        .filter_hits =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_FILTER_HIT, r),
+        .memory_used =
+            sqlite3_stmt_status(m_stmt, SQLITE_STMTSTATUS_MEMUSED, 0),
+    };
+}
+
+void sqlw::Statement::report_counters() noexcept
+{
+    if (nullptr != m_stmt && m_connection->has_counters_callback())
+    {
+        try
+        {
+            m_connection->check_counters(sqlite3_sql(m_stmt), counters());
+        }
+        catch (...)
+        {
+            // Steps are noexcept; a throwing callback only loses the report.
+        }
     }
 }
+
+void sqlw::Statement::publish_changes() noexcept
+{
+    if (nullptr != m_connection && nullptr != m_connection->change_feed())
+    {
+        m_connection->change_feed()->publish(m_connection);
+    }
+}
+
+void sqlw::Statement::set_step_status(int rc) noexcept
+{
+    if (SQLITE_INTERRUPT == rc && nullptr != m_connection)
+    {
+        m_status = m_connection->interrupt_status();
+        return;
+    }
+
+    m_status = status::Code{rc};
+}
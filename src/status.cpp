@@ -30,6 +30,14 @@ struct ErrorCategory : std::error_category
         case Code::UNUSED_PARAMETERS_ERROR:
             return "some paramaters where not bound";
             break;
+        case Code::MAPPING_ERROR:
+            return "result columns don't match the row type";
+        case Code::PARSE_ERROR:
+            return "malformed input record";
+        case Code::QUERY_CANCELLED:
+            return "query was cancelled";
+        case Code::DEADLINE_EXCEEDED:
+            return "query deadline exceeded";
         }
 
         return sqlite3_errstr(ec);
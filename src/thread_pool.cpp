@@ -0,0 +1,155 @@
+#include "sqlw/thread_pool.hpp"
+#include <utility>
+
+namespace
+{
+thread_local const sqlw::ThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+} // namespace
+
+sqlw::ThreadPool::ThreadPool(size_t workers)
+{
+    workers = 0 == workers ? 1 : workers;
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        m_workers.emplace_back([this, i]() { run(i); });
+    }
+}
+
+sqlw::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_work_cv.notify_all();
+    m_workers.clear();
+}
+
+void sqlw::ThreadPool::submit(sqlw::ThreadPool::task_t task)
+{
+    size_t queue = 0;
+
+    {
+        std::lock_guard lock{m_mutex};
+
+        queue = this == current_pool ? current_worker
+                                     : m_next_queue++ % m_queues.size();
+        m_unfinished++;
+    }
+
+    {
+        std::lock_guard lock{m_queues[queue]->mutex};
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+
+    // Counted only once queued, so every claimed task is in some queue.
+    {
+        std::lock_guard lock{m_mutex};
+        m_queued++;
+    }
+
+    m_work_cv.notify_one();
+}
+
+void sqlw::ThreadPool::wait()
+{
+    std::unique_lock lock{m_mutex};
+    m_idle_cv.wait(lock, [this]() { return 0 == m_unfinished; });
+
+    if (nullptr != m_exception)
+    {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+bool sqlw::ThreadPool::try_take(size_t worker, sqlw::ThreadPool::task_t& task)
+{
+    {
+        auto& own = *m_queues[worker];
+        std::lock_guard lock{own.mutex};
+
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < m_queues.size(); i++)
+    {
+        auto& victim = *m_queues[(worker + i) % m_queues.size()];
+        std::lock_guard lock{victim.mutex};
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void sqlw::ThreadPool::run(size_t worker)
+{
+    current_pool = this;
+    current_worker = worker;
+
+    for (;;)
+    {
+        {
+            std::unique_lock lock{m_mutex};
+            m_work_cv.wait(
+                lock,
+                [this]() { return m_queued > 0 || m_stopping; });
+
+            if (0 == m_queued)
+            {
+                return;
+            }
+
+            // Claims a task, which may sit in another worker's queue.
+            m_queued--;
+        }
+
+        task_t task;
+
+        // A task pushed after a queue was scanned can be missed while
+        // another worker takes the one we saw; rescan then.
+        while (!try_take(worker, task))
+        {
+            std::this_thread::yield();
+        }
+
+        try
+        {
+            task(worker);
+        }
+        catch (...)
+        {
+            std::lock_guard lock{m_mutex};
+
+            if (nullptr == m_exception)
+            {
+                m_exception = std::current_exception();
+            }
+        }
+
+        std::lock_guard lock{m_mutex};
+
+        if (0 == --m_unfinished)
+        {
+            m_idle_cv.notify_all();
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+class ArrayTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(sqlw::status::Condition::OK, con.status());
+
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, "
+                 "price REAL);"
+                 "INSERT INTO item VALUES (1, 'apple', 1.5), "
+                 "(2, 'pear', 2.0), (3, 'plum', 0.5), (4, 'fig', 3.0)"));
+    }
+
+    /**
+     * Ids of the rows matched by `sql` after `bind` binds parameter 1.
+     */
+    template <typename Bind>
+    auto ids(std::string_view sql, Bind bind) -> std::vector<int64_t>
+    {
+        sqlw::Statement stmt{&con};
+        stmt.prepare(sql);
+        bind(stmt);
+
+        std::vector<int64_t> result;
+
+        while (SQLITE_ROW == sqlite3_step(stmt.handle()))
+        {
+            result.push_back(sqlite3_column_int64(stmt.handle(), 0));
+        }
+
+        return result;
+    }
+
+    sqlw::Connection con{":memory:"};
+};
+
+TEST_F(ArrayTest, binds_integer_lists_of_any_length)
+{
+    sqlw::Statement stmt{&con};
+    stmt.prepare("SELECT id FROM item WHERE id IN sqlw_array(?) ORDER BY id");
+
+    for (const std::vector<int64_t>& list :
+         {std::vector<int64_t>{}, {3}, {4, 1, 9}, {1, 2, 3, 4, 2}})
+    {
+        std::vector<int64_t> expected;
+
+        for (int64_t id = 1; id <= 4; id++)
+        {
+            if (std::find(list.begin(), list.end(), id) != list.end())
+            {
+                expected.push_back(id);
+            }
+        }
+
+        sqlite3_reset(stmt.handle());
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt.bind(1, std::span<const int64_t>{list}).status());
+
+        std::vector<int64_t> found;
+
+        while (SQLITE_ROW == sqlite3_step(stmt.handle()))
+        {
+            found.push_back(sqlite3_column_int64(stmt.handle(), 0));
+        }
+
+        ASSERT_EQ(expected, found);
+    }
+}
+
+TEST_F(ArrayTest, binds_doubles_and_text)
+{
+    const std::vector<double> prices{0.5, 3.0};
+    ASSERT_EQ(
+        (std::vector<int64_t>{3, 4}),
+        ids("SELECT id FROM item WHERE price IN sqlw_array(?) ORDER BY id",
+            [&](sqlw::Statement& stmt) {
+                stmt.bind(1, std::span<const double>{prices});
+            }));
+
+    const std::vector<std::string_view> names{"pear", "apple", "kiwi"};
+    ASSERT_EQ(
+        (std::vector<int64_t>{1, 2}),
+        ids("SELECT id FROM item JOIN sqlw_array(?) a ON a.value = name "
+            "ORDER BY id",
+            [&](sqlw::Statement& stmt) {
+                stmt.bind(1, std::span<const std::string_view>{names});
+            }));
+}
+
+TEST_F(ArrayTest, yields_nothing_for_foreign_values)
+{
+    ASSERT_TRUE(ids("SELECT value FROM sqlw_array(?)", [](sqlw::Statement& s) {
+                    s.bind(1, 42);
+                }).empty());
+
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::ERROR,
+        stmt("SELECT value FROM sqlw_array"));
+}
@@ -0,0 +1,101 @@
+#include "sqlw/backup.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+
+static void fill(sqlw::Connection& con, int rows)
+{
+    sqlw::Statement stmt{&con};
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)"));
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt(
+            "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n "
+            "WHERE i < " +
+            std::to_string(rows) +
+            ") INSERT INTO item SELECT i, hex(randomblob(64)) FROM n"));
+}
+
+static std::string count(sqlw::Connection& con)
+{
+    sqlw::Statement stmt{&con};
+    std::string value;
+
+    stmt("SELECT count(*) FROM item", [&](sqlw::Statement::ExecArgs args) {
+        value = args.column_value;
+    });
+
+    return value;
+}
+
+TEST(Backup, copies_database_in_steps)
+{
+    sqlw::Connection source{":memory:"};
+    fill(source, 1000);
+
+    sqlw::Connection replica{":memory:"};
+    sqlw::Backup backup{&replica, &source};
+    ASSERT_EQ(sqlw::status::Condition::OK, backup.status());
+
+    int steps = 0;
+    sqlw::Backup::Progress last{};
+
+    const auto ec = backup.run(
+        {.pages_per_step = 2},
+        [&](const sqlw::Backup::Progress& p) {
+            steps++;
+            last = p;
+        });
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec;
+    ASSERT_GT(steps, 1);
+    ASSERT_EQ(0, last.remaining);
+    ASSERT_EQ(1.0, last.done());
+    ASSERT_EQ("1000", count(replica));
+}
+
+TEST(Backup, stops_on_request)
+{
+    sqlw::Connection source{":memory:"};
+    fill(source, 1000);
+
+    sqlw::Connection replica{":memory:"};
+    sqlw::Backup backup{&replica, &source};
+
+    std::stop_source stop;
+    const auto ec = backup.run(
+        {.pages_per_step = 1},
+        [&](const sqlw::Backup::Progress&) { stop.request_stop(); },
+        stop.get_token());
+
+    ASSERT_EQ(sqlw::status::Code{SQLITE_INTERRUPT}, ec);
+}
+
+TEST(BackupJob, copies_file_in_background)
+{
+    auto path = std::filesystem::temp_directory_path() / "test_backup.db";
+    std::remove(path.string().data());
+
+    {
+        sqlw::Connection source{path.string()};
+        fill(source, 500);
+    }
+
+    sqlw::Connection replica{":memory:"};
+    sqlw::BackupJob job{path.string(), &replica, {.pages_per_step = 4}};
+
+    ASSERT_EQ(sqlw::status::Condition::OK, job.wait());
+    ASSERT_TRUE(job.is_finished());
+    ASSERT_EQ(0, job.progress().remaining);
+    ASSERT_GT(job.progress().page_count, 0);
+    ASSERT_EQ("500", count(replica));
+
+    std::remove(path.string().data());
+}
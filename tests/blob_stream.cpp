@@ -0,0 +1,118 @@
+#include "sqlw/blob_stream.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+class BlobStreamTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE artifact (id INTEGER PRIMARY KEY, data BLOB)"));
+
+        for (int id = 1; id <= 2; id++)
+        {
+            stmt.prepare("INSERT INTO artifact (id, data) VALUES (?, ?)")
+                .bind(1, id)
+                .bind_zeroblob(2, blob_size)
+                .exec();
+            ASSERT_EQ(sqlw::status::Condition::DONE, stmt.status());
+        }
+    }
+
+    static constexpr size_t blob_size = 10'000;
+    sqlw::Connection con{":memory:"};
+};
+
+TEST_F(BlobStreamTest, writes_and_reads_in_chunks)
+{
+    sqlw::BlobStream blob{&con};
+    blob.open("artifact", "data", 1, true);
+    ASSERT_EQ(sqlw::status::Condition::OK, blob.status());
+    ASSERT_EQ(blob_size, blob.size());
+
+    std::array<std::byte, 64> chunk;
+
+    for (size_t written = 0; written < blob_size; written += chunk.size())
+    {
+        const size_t n = std::min(chunk.size(), blob_size - written);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            chunk[i] = static_cast<std::byte>((written + i) % 251);
+        }
+
+        blob.write({chunk.data(), n});
+        ASSERT_EQ(sqlw::status::Condition::OK, blob.status());
+    }
+
+    ASSERT_EQ(blob_size, blob.offset());
+
+    blob.seek(0);
+    std::vector<std::byte> data;
+    std::array<std::byte, 1000> buffer;
+
+    while (size_t n = blob.read(buffer))
+    {
+        data.insert(data.end(), buffer.begin(), buffer.begin() + n);
+    }
+
+    ASSERT_EQ(sqlw::status::Condition::OK, blob.status());
+    ASSERT_EQ(blob_size, data.size());
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        ASSERT_EQ(static_cast<std::byte>(i % 251), data[i]);
+    }
+}
+
+TEST_F(BlobStreamTest, reopens_another_row)
+{
+    sqlw::BlobStream blob{&con};
+    blob.open("artifact", "data", 1, true);
+
+    const std::array<std::byte, 3> data{
+        std::byte{1},
+        std::byte{2},
+        std::byte{3}};
+
+    blob.reopen(2).write(data);
+    ASSERT_EQ(sqlw::status::Condition::OK, blob.status());
+
+    sqlw::Statement stmt{&con};
+    std::string value;
+    stmt("SELECT hex(substr(data, 1, 3)) FROM artifact WHERE id = 2",
+         [&](sqlw::Statement::ExecArgs args) { value = args.column_value; });
+
+    ASSERT_EQ("010203", value);
+}
+
+TEST_F(BlobStreamTest, fails_to_write_past_the_end)
+{
+    sqlw::BlobStream blob{&con};
+    blob.open("artifact", "data", 1, true).seek(blob_size - 1);
+
+    const std::array<std::byte, 2> data{};
+    blob.write(data);
+
+    ASSERT_EQ(sqlw::status::Condition::ERROR, blob.status());
+    ASSERT_EQ(blob_size - 1, blob.offset());
+}
+
+TEST_F(BlobStreamTest, fails_to_open_missing_row)
+{
+    sqlw::BlobStream blob{&con};
+    blob.open("artifact", "data", 42);
+
+    ASSERT_FALSE(blob.is_open());
+    ASSERT_EQ(sqlw::status::Condition::ERROR, blob.status());
+    ASSERT_EQ(0, blob.read({}));
+}
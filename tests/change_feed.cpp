@@ -0,0 +1,231 @@
+#include "sqlw/change_feed.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+class ChangeFeedTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)"));
+
+        feed.attach(&con);
+    }
+
+    sqlw::Connection con{":memory:"};
+    sqlw::ChangeFeed feed{16};
+};
+
+TEST_F(ChangeFeedTest, publishes_changes_on_commit)
+{
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("BEGIN;"
+             "INSERT INTO item VALUES (1, 'apple'), (2, 'pear');"
+             "UPDATE item SET name = 'plum' WHERE id = 2;"));
+
+    sqlw::ChangeFeed::Change change;
+    ASSERT_FALSE(feed.pop(change));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, stmt("COMMIT"));
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("DELETE FROM item WHERE id = 1"));
+
+    const auto changes = feed.drain();
+    ASSERT_EQ(4, changes.size());
+    ASSERT_EQ(2, feed.transactions());
+
+    ASSERT_EQ(sqlw::ChangeFeed::Operation::INSERT, changes[0].op);
+    ASSERT_EQ("main", changes[0].database);
+    ASSERT_EQ("item", changes[0].table);
+    ASSERT_EQ(1, changes[0].rowid);
+    ASSERT_EQ(1, changes[0].transaction);
+
+    ASSERT_EQ(sqlw::ChangeFeed::Operation::UPDATE, changes[2].op);
+    ASSERT_EQ(2, changes[2].rowid);
+    ASSERT_EQ(1, changes[2].transaction);
+
+    ASSERT_EQ(sqlw::ChangeFeed::Operation::DELETE, changes[3].op);
+    ASSERT_EQ(1, changes[3].rowid);
+    ASSERT_EQ(2, changes[3].transaction);
+}
+
+TEST_F(ChangeFeedTest, discards_changes_on_rollback)
+{
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("BEGIN;"
+             "INSERT INTO item VALUES (1, 'apple');"
+             "ROLLBACK;"
+             "INSERT INTO item VALUES (2, 'pear')"));
+
+    const auto changes = feed.drain();
+    ASSERT_EQ(1, changes.size());
+    ASSERT_EQ(2, changes[0].rowid);
+}
+
+TEST_F(ChangeFeedTest, publishes_changes_rolled_back_to_savepoint)
+{
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("BEGIN;"
+             "SAVEPOINT s;"
+             "INSERT INTO item VALUES (1, 'apple');"
+             "ROLLBACK TO s;"
+             "RELEASE s;"
+             "COMMIT"));
+
+    // The row is gone, but ROLLBACK TO doesn't fire the rollback hook.
+    const auto changes = feed.drain();
+    ASSERT_EQ(1, changes.size());
+    ASSERT_EQ(1, changes[0].rowid);
+}
+
+TEST_F(ChangeFeedTest, counts_dropped_changes)
+{
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 "
+             "FROM n WHERE i < 20) INSERT INTO item SELECT i, '' FROM n"));
+
+    ASSERT_EQ(16, feed.drain().size());
+    ASSERT_EQ(4, feed.dropped());
+}
+
+TEST_F(ChangeFeedTest, stops_after_detach)
+{
+    feed.detach(&con);
+
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("INSERT INTO item VALUES (1, 'apple')"));
+
+    ASSERT_TRUE(feed.drain().empty());
+}
+
+TEST(ChangeFeed, publishes_only_completed_commits)
+{
+    const auto path =
+        std::filesystem::temp_directory_path() / "test_change_feed.db";
+    std::remove(path.string().data());
+
+    sqlw::Connection writer{path.string()};
+    sqlw::Connection reader{path.string()};
+    sqlw::ChangeFeed feed{16};
+    sqlw::Statement stmt{&writer};
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)"));
+
+    feed.attach(&writer);
+
+    sqlw::Statement read{&reader};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        read("BEGIN; SELECT count(*) FROM item"));
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("BEGIN; INSERT INTO item VALUES (1, 'apple')"));
+
+    // The reader's lock makes the commit fail after the commit hook ran.
+    ASSERT_EQ(sqlw::status::Code{SQLITE_BUSY}, stmt("COMMIT"));
+    ASSERT_TRUE(feed.drain().empty());
+
+    ASSERT_EQ(sqlw::status::Condition::OK, read("COMMIT"));
+    ASSERT_EQ(sqlw::status::Condition::OK, stmt("COMMIT"));
+
+    const auto changes = feed.drain();
+    ASSERT_EQ(1, changes.size());
+    ASSERT_EQ(1, changes[0].rowid);
+    ASSERT_EQ(1, feed.transactions());
+
+    feed.detach(&writer);
+    std::remove(path.string().data());
+}
+
+TEST(ChangeFeed, follows_reopened_connections)
+{
+    sqlw::ChangeFeed feed{16};
+
+    for (int i = 1; i <= 20; i++)
+    {
+        sqlw::Connection con{":memory:"};
+        feed.attach(&con);
+
+        sqlw::Statement stmt{&con};
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY);"
+                 "INSERT INTO item VALUES (1)"));
+
+        con.close();
+        ASSERT_EQ(nullptr, con.change_feed());
+
+        // Only the INSERT, CREATE TABLE doesn't fire the update hook.
+        ASSERT_EQ(1, feed.drain().size()) << "connection " << i;
+    }
+
+    ASSERT_EQ(20, feed.transactions());
+}
+
+TEST_F(ChangeFeedTest, is_consumed_from_another_thread)
+{
+    constexpr int rows = 200;
+    std::atomic<int> seen{0};
+
+    std::jthread consumer{[&](std::stop_token token) {
+        sqlw::ChangeFeed::Change change;
+
+        for (;;)
+        {
+            if (feed.pop(change))
+            {
+                seen++;
+            }
+            else if (token.stop_requested())
+            {
+                return;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    sqlw::Statement stmt{&con};
+
+    for (int i = 1; i <= rows; i++)
+    {
+        stmt.prepare("INSERT INTO item VALUES (?, 'x')").bind(1, i).exec();
+        ASSERT_EQ(sqlw::status::Condition::DONE, stmt.status());
+
+        while (seen.load() + static_cast<int>(feed.dropped()) < i)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    consumer.request_stop();
+    consumer.join();
+
+    ASSERT_EQ(rows, seen.load());
+}
@@ -0,0 +1,155 @@
+#include "sqlw/checkpointer.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+class CheckpointerTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        remove_files();
+        con.connect(path.string());
+
+        sqlw::Statement stmt{&con};
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("PRAGMA journal_mode = WAL;"
+                 "CREATE TABLE item (id INTEGER PRIMARY KEY, value TEXT)"));
+    }
+
+    void TearDown() override
+    {
+        con.close();
+        remove_files();
+    }
+
+    static void remove_files()
+    {
+        std::remove(path.string().data());
+        std::remove((path.string() + "-wal").data());
+        std::remove((path.string() + "-shm").data());
+    }
+
+    void insert(int rows)
+    {
+        sqlw::Statement stmt{&con};
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 "
+                 "FROM n WHERE i < " +
+                 std::to_string(rows) +
+                 ") INSERT INTO item (value) SELECT randomblob(512) FROM n"));
+    }
+
+    static auto wal_size() -> uintmax_t
+    {
+        return std::filesystem::file_size(path.string() + "-wal");
+    }
+
+    template <typename Predicate>
+    static auto eventually(Predicate predicate) -> bool
+    {
+        const auto until =
+            std::chrono::steady_clock::now() + std::chrono::seconds{5};
+
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > until)
+            {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        return true;
+    }
+
+    sqlw::Connection con;
+
+    static inline std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_checkpointer.db";
+};
+
+TEST_F(CheckpointerTest, checkpoints_in_background)
+{
+    sqlw::Checkpointer checkpointer{
+        path.string(),
+        {.passive_frames = 10, .interval = std::chrono::hours{1}}};
+    ASSERT_EQ(sqlw::status::Condition::OK, checkpointer.status());
+
+    checkpointer.attach(&con);
+    insert(500);
+
+    ASSERT_TRUE(eventually([&] {
+        return checkpointer.stats().frames_checkpointed > 0;
+    }));
+
+    const auto stats = checkpointer.stats();
+    ASSERT_GT(stats.wal_frames, 10);
+    ASSERT_GE(stats.checkpoints, 1);
+    ASSERT_EQ(0, stats.failures);
+    ASSERT_GT(stats.total_duration.count(), 0);
+
+    checkpointer.detach(&con);
+}
+
+TEST_F(CheckpointerTest, escalates_to_truncate)
+{
+    sqlw::Checkpointer checkpointer{
+        path.string(),
+        {.passive_frames = 10,
+         .restart_frames = 10,
+         .truncate_frames = 50,
+         .interval = std::chrono::hours{1}}};
+
+    checkpointer.attach(&con);
+    insert(1000);
+
+    ASSERT_TRUE(eventually([&] { return checkpointer.stats().truncates > 0; }));
+
+    const auto stats = checkpointer.stats();
+    ASSERT_EQ(0, stats.wal_frames);
+    ASSERT_GE(stats.frames_checkpointed, 50);
+    ASSERT_EQ(0, wal_size());
+
+    checkpointer.detach(&con);
+}
+
+TEST_F(CheckpointerTest, restart_waits_for_readers)
+{
+    sqlw::Checkpointer checkpointer{
+        path.string(),
+        {.interval = std::chrono::hours{1},
+         .busy_timeout = std::chrono::milliseconds{10}}};
+
+    sqlw::Connection reader{path.string()};
+    sqlw::Statement read{&reader};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        read("BEGIN; SELECT count(*) FROM item"));
+
+    insert(10);
+
+    ASSERT_EQ(
+        sqlw::status::Code{SQLITE_BUSY},
+        checkpointer.checkpoint(sqlw::Checkpointer::Mode::RESTART));
+    ASSERT_EQ(1, checkpointer.stats().busy);
+
+    ASSERT_EQ(sqlw::status::Condition::OK, read("COMMIT"));
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        checkpointer.checkpoint(sqlw::Checkpointer::Mode::TRUNCATE));
+
+    const auto stats = checkpointer.stats();
+    ASSERT_EQ(1, stats.truncates);
+    ASSERT_EQ(0, stats.wal_frames);
+    ASSERT_EQ(0, wal_size());
+}
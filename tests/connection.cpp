@@ -1,9 +1,13 @@
 #include "sqlw/connection.hpp"
 #include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <chrono>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <stop_token>
+#include <thread>
 
 TEST(Connection, can_create_new_db_file_on_ctor)
 {
@@ -46,3 +50,216 @@ TEST(Connection, can_open_in_memory_db)
     std::error_code ec = db_con.status();
     ASSERT_TRUE(sqlw::status::Condition::OK == ec) << ec;
 }
+
+TEST(Connection, reports_cache_hits)
+{
+    sqlw::Connection con{":memory:"};
+
+    ASSERT_EQ(sqlw::status::Condition::OK, con.set_cache_size(-1024));
+    ASSERT_EQ(sqlw::status::Condition::OK, con.set_cache_spill(0));
+
+    ASSERT_EQ(
+        SQLITE_OK,
+        sqlite3_exec(
+            con.handle(),
+            "CREATE TABLE t (a INTEGER);"
+            "INSERT INTO t VALUES (1), (2), (3);"
+            "SELECT * FROM t; SELECT * FROM t;",
+            nullptr,
+            nullptr,
+            nullptr));
+
+    const auto s = con.db_status(true);
+    ASSERT_GT(s.cache_used, 0);
+    ASSERT_GT(s.cache_hits, 0);
+    ASSERT_GT(s.cache_hit_rate(), 0.0);
+    ASSERT_LE(s.cache_hit_rate(), 1.0);
+    ASSERT_GT(s.schema_used, 0);
+
+    ASSERT_EQ(0, con.db_status().cache_hits);
+}
+
+TEST(Connection, configures_lookaside)
+{
+    if (sqlite3_compileoption_used("OMIT_LOOKASIDE"))
+    {
+        GTEST_SKIP() << "SQLite is built without lookaside";
+    }
+
+    sqlw::Connection con{":memory:"};
+
+    ASSERT_EQ(sqlw::status::Condition::OK, con.set_lookaside(256, 64));
+
+    ASSERT_EQ(
+        SQLITE_OK,
+        sqlite3_exec(
+            con.handle(),
+            "CREATE TABLE t (a TEXT); INSERT INTO t VALUES ('a'), ('b');",
+            nullptr,
+            nullptr,
+            nullptr));
+
+    const auto s = con.db_status();
+    ASSERT_GT(s.lookaside_hits, 0);
+    ASSERT_GT(s.lookaside_hit_rate(), 0.0);
+}
+
+TEST(Connection, maps_database_into_memory)
+{
+    auto path = std::filesystem::temp_directory_path() / "test_mmap.db";
+    std::remove(path.string().data());
+
+    {
+        sqlw::Connection db_con{path.string()};
+        ASSERT_EQ(
+            SQLITE_OK,
+            sqlite3_exec(
+                db_con.handle(),
+                "CREATE TABLE t (a TEXT);"
+                "INSERT INTO t VALUES ('a'), ('b');",
+                nullptr,
+                nullptr,
+                nullptr));
+    }
+
+    sqlw::Connection db_con{path.string(), SQLITE_OPEN_READONLY};
+    ASSERT_EQ(sqlw::status::Condition::OK, db_con.status());
+    ASSERT_TRUE(db_con.is_read_only());
+
+    ASSERT_EQ(sqlw::status::Condition::OK, db_con.set_mmap_size(1 << 20));
+
+    const auto s = db_con.mmap_status();
+    ASSERT_EQ(1 << 20, s.limit);
+    ASSERT_GT(s.page_count, 0);
+    ASSERT_EQ(s.page_count, s.mapped_pages);
+    ASSERT_EQ(1.0, s.coverage());
+
+    ASSERT_NE(
+        SQLITE_OK,
+        sqlite3_exec(
+            db_con.handle(),
+            "INSERT INTO t VALUES ('c')",
+            nullptr,
+            nullptr,
+            nullptr));
+
+    db_con.close();
+    std::remove(path.string().data());
+}
+
+TEST(Connection, tracks_live_statements)
+{
+    sqlw::Connection db_con{":memory:"};
+    ASSERT_EQ(0, db_con.live_statements());
+
+    {
+        sqlw::Statement a{&db_con};
+        sqlw::Statement b{&db_con};
+        ASSERT_EQ(2, db_con.live_statements());
+
+        a.prepare("SELECT 1");
+        a.prepare("SELECT 2");
+        b.prepare("SELECT 3");
+        ASSERT_EQ(2, db_con.open_statements());
+        ASSERT_GT(db_con.statement_memory(), 0);
+
+        a = std::move(b);
+        ASSERT_EQ(1, db_con.live_statements());
+        ASSERT_EQ(1, db_con.open_statements());
+
+        sqlw::Statement c{std::move(a)};
+        ASSERT_EQ(1, db_con.live_statements());
+        ASSERT_EQ(1, db_con.open_statements());
+    }
+
+    ASSERT_EQ(0, db_con.live_statements());
+    ASSERT_EQ(0, db_con.open_statements());
+}
+
+TEST(Connection, finalizes_statements_on_close)
+{
+    sqlw::Connection db_con{":memory:"};
+    sqlw::Statement stmt{&db_con};
+    sqlw::Statement idle{&db_con};
+    stmt.prepare("SELECT 1");
+
+    db_con.close();
+    ASSERT_EQ(1, db_con.finalized_on_close());
+    ASSERT_EQ(0, db_con.live_statements());
+    ASSERT_EQ(sqlw::status::Code::CLOSED_HANDLE, stmt.status());
+    ASSERT_EQ(nullptr, stmt.handle());
+
+    ASSERT_EQ(sqlw::status::Code::CLOSED_HANDLE, stmt("SELECT 1"));
+}
+
+TEST(Connection, moves_statements_along)
+{
+    sqlw::Connection first{":memory:"};
+    sqlw::Statement stmt{&first};
+
+    sqlw::Connection second{std::move(first)};
+    ASSERT_EQ(1, second.live_statements());
+    ASSERT_EQ(0, first.live_statements());
+    ASSERT_EQ(sqlw::status::Condition::OK, stmt("SELECT 1"));
+}
+
+static constexpr std::string_view endless_query =
+    "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) "
+    "SELECT count(*) FROM c";
+
+TEST(Connection, stops_queries_at_deadline)
+{
+    using namespace std::chrono_literals;
+
+    sqlw::Connection db_con{":memory:"};
+    sqlw::Statement stmt{&db_con};
+
+    {
+        sqlw::ScopedDeadline deadline{&db_con, 20ms};
+        ASSERT_EQ(sqlw::status::Code::DEADLINE_EXCEEDED, stmt(endless_query));
+    }
+
+    ASSERT_FALSE(db_con.deadline().has_value());
+    ASSERT_EQ(sqlw::status::Condition::OK, stmt("SELECT 1"));
+
+    db_con.set_deadline(std::chrono::steady_clock::now() - 1s);
+    ASSERT_EQ(sqlw::status::Code::DEADLINE_EXCEEDED, stmt(endless_query));
+    db_con.clear_deadline();
+}
+
+TEST(Connection, cancels_queries_through_stop_token)
+{
+    using namespace std::chrono_literals;
+
+    sqlw::Connection db_con{":memory:"};
+    sqlw::Statement stmt{&db_con};
+    std::stop_source source;
+    db_con.set_stop_token(source.get_token());
+    db_con.set_progress_interval(100);
+
+    std::jthread canceller{[&]() {
+        std::this_thread::sleep_for(20ms);
+        source.request_stop();
+    }};
+
+    ASSERT_EQ(sqlw::status::Code::QUERY_CANCELLED, stmt(endless_query));
+
+    db_con.set_stop_token({});
+    ASSERT_EQ(sqlw::status::Condition::OK, stmt("SELECT 1"));
+}
+
+TEST(Connection, interrupts_from_another_thread)
+{
+    using namespace std::chrono_literals;
+
+    sqlw::Connection db_con{":memory:"};
+    sqlw::Statement stmt{&db_con};
+
+    std::jthread interrupter{[&]() {
+        std::this_thread::sleep_for(20ms);
+        db_con.interrupt();
+    }};
+
+    ASSERT_EQ(sqlw::status::Code::QUERY_CANCELLED, stmt(endless_query));
+    ASSERT_EQ(sqlw::status::Condition::ERROR, stmt.status());
+}
@@ -0,0 +1,136 @@
+#include "sqlw/exporter.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <chrono>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+class ExporterTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER, name TEXT, price, data);"
+                 "INSERT INTO item VALUES "
+                 "(1, 'plain', 1.5, NULL),"
+                 "(2, 'with \"quotes\", comma', NULL, x'00ff'),"
+                 "(3, 'multi\nline', 7, NULL)"));
+    }
+
+    /**
+     * Runs `export_to` with the write end of a pipe and returns
+     * everything written to it.
+     */
+    template <typename F> auto capture(F export_to) -> std::string
+    {
+        std::array<int, 2> fds{};
+        EXPECT_EQ(0, ::pipe(fds.data()));
+
+        std::string output;
+        std::thread reader{[&]() {
+            char buffer[256];
+            ssize_t n = 0;
+
+            while ((n = ::read(fds[0], buffer, sizeof(buffer))) > 0)
+            {
+                output.append(buffer, n);
+            }
+        }};
+
+        export_to(fds[1]);
+        ::close(fds[1]);
+        reader.join();
+        ::close(fds[0]);
+
+        return output;
+    }
+
+    sqlw::Connection con{":memory:"};
+};
+
+TEST_F(ExporterTest, exports_csv)
+{
+    sqlw::Exporter exporter{&con, {.chunk_size = 16}};
+
+    const auto output = capture([&](int fd) {
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            exporter.run("SELECT * FROM item ORDER BY id", fd));
+    });
+
+    ASSERT_EQ(
+        "id,name,price,data\n"
+        "1,plain,1.5,\n"
+        "2,\"with \"\"quotes\"\", comma\",,00ff\n"
+        "3,\"multi\nline\",7,\n",
+        output);
+    ASSERT_EQ(3, exporter.stats().rows);
+    ASSERT_EQ(output.size(), exporter.stats().bytes_written);
+    ASSERT_GT(exporter.stats().chunks, 1);
+}
+
+TEST_F(ExporterTest, exports_json_lines_with_params)
+{
+    sqlw::Exporter exporter{
+        &con,
+        {.format = sqlw::Exporter::Format::JSON_LINES}};
+
+    const std::array<sqlw::Statement::bindable_t, 1> params{
+        sqlw::Statement::bindable_t{"1", sqlw::Type::SQL_INT}};
+
+    const auto output = capture([&](int fd) {
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            exporter.run(
+                "SELECT id, name, price, data FROM item WHERE id > ? "
+                "ORDER BY id",
+                fd,
+                params));
+    });
+
+    ASSERT_EQ(
+        "{\"id\":2,\"name\":\"with \\\"quotes\\\", comma\","
+        "\"price\":null,\"data\":\"00ff\"}\n"
+        "{\"id\":3,\"name\":\"multi\\nline\",\"price\":7,\"data\":null}\n",
+        output);
+    ASSERT_EQ(1, exporter.stats().chunks);
+}
+
+TEST_F(ExporterTest, reports_write_errors)
+{
+    sqlw::Exporter exporter{&con, {.chunk_size = 1}};
+
+    ASSERT_EQ(
+        std::errc::bad_file_descriptor,
+        exporter.run("SELECT * FROM item", -1));
+}
+
+TEST_F(ExporterTest, reports_deadline)
+{
+    using namespace std::chrono_literals;
+
+    sqlw::Exporter exporter{&con};
+
+    capture([&](int fd) {
+        con.set_deadline(std::chrono::steady_clock::now() - 1s);
+        ASSERT_EQ(
+            sqlw::status::Code::DEADLINE_EXCEEDED,
+            exporter.run(
+                "WITH RECURSIVE c(x) AS "
+                "(SELECT 1 UNION ALL SELECT x + 1 FROM c) "
+                "SELECT count(*) FROM c",
+                fd));
+        con.clear_deadline();
+    });
+
+    ASSERT_EQ(sqlw::status::Code{SQLITE_INTERRUPT}, con.interrupt_status());
+}
@@ -0,0 +1,229 @@
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+class FunctionTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, "
+                 "price REAL, tag BLOB);"
+                 "INSERT INTO item VALUES (1, 'apple', 1.5, x'01'), "
+                 "(2, 'pear', 2.0, NULL), (3, 'plum', 0.5, x'0203'), "
+                 "(4, 'fig', 3.0, x'')"));
+    }
+
+    sqlw::Connection con{":memory:"};
+};
+
+TEST_F(FunctionTest, calls_scalar_with_typed_arguments)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_function(
+            "score",
+            [](int64_t id, double price, std::string_view name) -> double {
+                return id * price + name.size();
+            },
+            SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS));
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<double>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as(
+            "SELECT score(id, price, name) FROM item ORDER BY id",
+            rows));
+
+    const std::vector<std::tuple<double>> expected{{6.5}, {8.0}, {5.5}, {15}};
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(FunctionTest, maps_null_to_optional)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_function(
+            "tag_size",
+            [](std::optional<std::span<const std::byte>> tag)
+                -> std::optional<int64_t> {
+                if (!tag.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                return tag->size();
+            },
+            SQLITE_DETERMINISTIC));
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<std::optional<int64_t>>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as("SELECT tag_size(tag) FROM item ORDER BY id", rows));
+
+    const std::vector<std::tuple<std::optional<int64_t>>> expected{
+        {1},
+        {std::nullopt},
+        {2},
+        {0}};
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(FunctionTest, deterministic_function_can_be_indexed)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_function(
+            "shout",
+            [](std::string_view s) {
+                std::string result{s};
+
+                for (auto& c : result)
+                {
+                    c = static_cast<char>(std::toupper(c));
+                }
+
+                return result;
+            },
+            SQLITE_DETERMINISTIC));
+
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("CREATE INDEX item_shout ON item (shout(name))"));
+
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as("SELECT id FROM item WHERE shout(name) = 'PEAR'", rows));
+    ASSERT_EQ(1, rows.size());
+    ASSERT_EQ(2, std::get<0>(rows[0]));
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_function("noisy", [](int64_t x) { return x; }));
+    ASSERT_EQ(
+        sqlw::status::Condition::ERROR,
+        stmt("CREATE INDEX item_noisy ON item (noisy(id))"));
+}
+
+TEST_F(FunctionTest, reports_exceptions_as_errors)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_function("fail", [](int64_t) -> int64_t {
+            throw std::runtime_error{"no way"};
+        }));
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::ERROR,
+        stmt.query_as("SELECT fail(1)", rows));
+    ASSERT_STREQ("no way", sqlite3_errmsg(con.handle()));
+}
+
+TEST_F(FunctionTest, aggregates_per_group)
+{
+    struct Mean
+    {
+        double sum{0};
+        int64_t count{0};
+    };
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_aggregate<Mean>(
+            "mean",
+            [](Mean& m, double x) {
+                m.sum += x;
+                m.count++;
+            },
+            [](Mean& m) -> std::optional<double> {
+                if (0 == m.count)
+                {
+                    return std::nullopt;
+                }
+
+                return m.sum / m.count;
+            },
+            SQLITE_DETERMINISTIC));
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<int64_t, std::optional<double>>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as(
+            "SELECT id % 2, mean(price) FROM item GROUP BY 1 ORDER BY 1",
+            rows));
+
+    const std::vector<std::tuple<int64_t, std::optional<double>>> expected{
+        {0, 2.5},
+        {1, 1.0}};
+    ASSERT_EQ(expected, rows);
+
+    std::vector<std::tuple<std::optional<double>>> empty;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as("SELECT mean(price) FROM item WHERE id > 10", empty));
+    ASSERT_EQ(1, empty.size());
+    ASSERT_FALSE(std::get<0>(empty[0]).has_value());
+}
+
+TEST_F(FunctionTest, computes_sliding_windows)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        con.create_window_function<std::vector<std::string>>(
+            "names",
+            [](std::vector<std::string>& names, std::string_view name) {
+                names.emplace_back(name);
+            },
+            [](std::vector<std::string>& names, std::string_view) {
+                names.erase(names.begin());
+            },
+            [](std::vector<std::string>& names) {
+                std::string result;
+
+                for (const auto& name : names)
+                {
+                    result += result.empty() ? name : "," + name;
+                }
+
+                return result;
+            },
+            SQLITE_DETERMINISTIC));
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<std::string>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as(
+            "SELECT names(name) OVER (ORDER BY id ROWS BETWEEN 1 PRECEDING "
+            "AND CURRENT ROW) FROM item ORDER BY id",
+            rows));
+
+    const std::vector<std::tuple<std::string>> expected{
+        {"apple"},
+        {"apple,pear"},
+        {"pear,plum"},
+        {"plum,fig"}};
+    ASSERT_EQ(expected, rows);
+}
@@ -0,0 +1,201 @@
+#include "sqlw/importer.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+class ImporterTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item ("
+                 "id INTEGER PRIMARY KEY, name TEXT NOT NULL, price, extra)"));
+    }
+
+    void TearDown() override
+    {
+        if (-1 != fd)
+        {
+            ::close(fd);
+        }
+
+        std::remove(path.string().data());
+    }
+
+    auto input(std::string_view content) -> int
+    {
+        std::ofstream{path, std::ios::binary} << content;
+        fd = ::open(path.string().c_str(), O_RDONLY);
+
+        return fd;
+    }
+
+    auto rows() -> std::string
+    {
+        sqlw::Statement stmt{&con};
+        std::string result;
+
+        stmt(
+            "SELECT group_concat(id || ':' || name || ':' || typeof(price) || "
+            "':' || ifnull(price, '') || ':' || ifnull(extra, ''), '|') "
+            "FROM item",
+            [&](sqlw::Statement::ExecArgs args) {
+                result = args.column_value;
+            });
+
+        return result;
+    }
+
+    sqlw::Connection con{":memory:"};
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_import.txt";
+    int fd{-1};
+};
+
+TEST_F(ImporterTest, imports_csv_with_header)
+{
+    sqlw::Importer importer{
+        &con,
+        "item",
+        {.batch_size = 2, .chunk_size = 16}};
+
+    const auto ec = importer.run(input(
+        "id,name,price,extra\r\n"
+        "1,apple,1.5,\r\n"
+        "2,\"pear, green\",2,\"said \"\"hi\"\"\"\n"
+        "3,\"multi\nline\",,x"));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec.message();
+    ASSERT_EQ(
+        "1:apple:real:1.5:|"
+        "2:pear, green:integer:2:said \"hi\"|"
+        "3:multi\nline:null::x",
+        rows());
+
+    const auto& stats = importer.stats();
+    ASSERT_EQ(3, stats.rows_imported);
+    ASSERT_EQ(0, stats.rows_quarantined);
+    ASSERT_EQ(2, stats.batches);
+    ASSERT_GT(stats.bytes_read, 0);
+    ASSERT_GT(stats.rows_per_second(), 0.0);
+}
+
+TEST_F(ImporterTest, quarantines_bad_records)
+{
+    sqlw::Importer importer{
+        &con,
+        "item",
+        {.header = false, .columns = {"id", "name", "price", "extra"}}};
+
+    std::vector<std::pair<size_t, std::string>> quarantined;
+    importer.on_quarantine(
+        [&](size_t line, std::string_view record, std::error_code ec) {
+            quarantined.emplace_back(line, record);
+            ASSERT_EQ(sqlw::status::Condition::ERROR, ec);
+        });
+
+    const auto ec = importer.run(input("1,a,1,\n"
+                                       "2,b\n"
+                                       "1,c,3,\n"
+                                       "\n"
+                                       "4,\"d,4,\n"));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec.message();
+    ASSERT_EQ("1:a:integer:1:", rows());
+    ASSERT_EQ(1, importer.stats().rows_imported);
+    ASSERT_EQ(3, importer.stats().rows_quarantined);
+
+    ASSERT_EQ(3, quarantined.size());
+    ASSERT_EQ(2, quarantined[0].first);
+    ASSERT_EQ("2,b", quarantined[0].second);
+    ASSERT_EQ(5, quarantined[1].first);
+    ASSERT_EQ(3, quarantined[2].first);
+    ASSERT_EQ("1,c,3,", quarantined[2].second);
+}
+
+TEST_F(ImporterTest, skips_header_narrower_than_columns)
+{
+    sqlw::Importer importer{
+        &con,
+        "item",
+        {.columns = {"id", "name", "price", "extra"}}};
+
+    const auto ec = importer.run(input("id,name\n"
+                                       "1,apple,1.5,\n"
+                                       "2,pear,2,x\n"));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec.message();
+    ASSERT_EQ("1:apple:real:1.5:|2:pear:integer:2:x", rows());
+    ASSERT_EQ(2, importer.stats().rows_imported);
+    ASSERT_EQ(0, importer.stats().rows_quarantined);
+}
+
+TEST_F(ImporterTest, keeps_csv_numbers_that_dont_round_trip_as_text)
+{
+    sqlw::Importer importer{
+        &con,
+        "item",
+        {.header = false, .columns = {"id", "name", "price", "extra"}}};
+
+    const auto ec = importer.run(input("1,00123,1e3,12345678901234567890\n"
+                                       "2,0.5,2.5,-7\n"));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec.message();
+    ASSERT_EQ(
+        "1:00123:text:1e3:12345678901234567890|"
+        "2:0.5:real:2.5:-7",
+        rows());
+}
+
+TEST_F(ImporterTest, imports_ndjson)
+{
+    sqlw::Importer importer{
+        &con,
+        "item",
+        {.format = sqlw::Importer::Format::NDJSON, .chunk_size = 8}};
+
+    size_t progress_calls = 0;
+    importer.on_progress(
+        [&](const sqlw::Importer::Stats&) { progress_calls++; });
+
+    const auto ec = importer.run(input(
+        R"({"id": 1, "name": "café \"x\"", "price": 2.5, "extra": null})"
+        "\n"
+        R"({"name": "b", "id": 2, "extra": {"tags": ["a", "}"]}, "price": 3})"
+        "\n"
+        R"({"id": 3, "name": "c", "price": true, "unknown": 1})"
+        "\n"
+        R"({"id": 4, "name": )"
+        "\n"));
+
+    ASSERT_EQ(sqlw::status::Condition::OK, ec) << ec.message();
+    ASSERT_EQ(
+        "1:caf\xc3\xa9 \"x\":real:2.5:|"
+        "2:b:integer:3:{\"tags\": [\"a\", \"}\"]}|"
+        "3:c:integer:1:",
+        rows());
+    ASSERT_EQ(1, importer.stats().rows_quarantined);
+    ASSERT_EQ(1, progress_calls);
+}
+
+TEST_F(ImporterTest, fails_on_missing_table)
+{
+    sqlw::Importer importer{&con, "missing"};
+
+    const auto ec = importer.run(input("a,b\n1,2\n"));
+
+    ASSERT_EQ(sqlw::status::Condition::ERROR, ec);
+    ASSERT_EQ(0, importer.stats().rows_imported);
+}
@@ -1,41 +1,107 @@
 #include "sqlw/json_string_result.hpp"
+#include "sqlw/connection.hpp"
 #include "sqlw/forward.hpp"
 #include "sqlw/statement.hpp"
-#include "sqlw/status.hpp"
+#include <array>
+#include <cstddef>
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
 
-TEST(JsonStringResult, can_give_json_result)
+class JsonStringResultTest : public testing::Test
 {
-    sqlw::Connection con{":memory:"};
-    sqlw::Statement stmt{&con};
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::DONE,
+            stmt(R"(CREATE TABLE user (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE
+            );
+            INSERT INTO user (id, name) VALUES (1,'john'),(2,'bob'))"));
+    }
+
+    /**
+     * Runs `sql` through a `Statement` into `jsr`.
+     */
+    auto query(std::string_view sql, sqlw::JsonStringResult& jsr)
+        -> std::error_code
+    {
+        sqlw::Statement stmt{&con};
 
-    stmt(R"(CREATE TABLE user (
-		id INTEGER PRIMARY KEY AUTOINCREMENT,
-		name TEXT NOT NULL UNIQUE
-	))");
+        return stmt(sql, [&](sqlw::Statement::ExecArgs args) {
+            // `id` is the first column of every row.
+            if (0 == args.column_name.compare("id"))
+            {
+                jsr.row(args.column_count);
+            }
 
-    stmt("INSERT INTO user (id, name) VALUES (1,'john'),(2,'bob')");
+            jsr.column(args.column_name, args.column_type, args.column_value);
+        });
+    }
 
-    ASSERT_EQ(sqlw::status::Code::SQLW_DONE, stmt.status())
-        << sqlw::status::verbose(stmt.status());
+    sqlw::Connection con{":memory:"};
+};
 
+TEST_F(JsonStringResultTest, can_give_json_result)
+{
     {
-        auto jsr =
-            stmt.operator()<sqlw::JsonStringResult>("SELECT * FROM user");
+        sqlw::JsonStringResult jsr;
 
-        ASSERT_EQ(sqlw::status::Code::SQLW_DONE, stmt.status())
-            << sqlw::status::verbose(stmt.status());
         ASSERT_EQ(
-            R"([{"id":1,"name":"john"},{"id":2,"name":"bob"}])",
-            jsr.get_array_result());
+            sqlw::status::Condition::DONE,
+            query("SELECT * FROM user", jsr));
+        ASSERT_TRUE(jsr.has_result());
+
+        const std::string json = jsr.get_array_result();
+        ASSERT_EQ(R"([{"id":1,"name":"john"},{"id":2,"name":"bob"}])", json);
     }
 
     {
-        auto jsr = stmt.operator()<sqlw::JsonStringResult>(
-            "SELECT * FROM user WHERE id = 2 LIMIT 1");
+        sqlw::JsonStringResult jsr;
 
-        ASSERT_EQ(sqlw::status::Code::SQLW_DONE, stmt.status())
-            << sqlw::status::verbose(stmt.status());
-        ASSERT_EQ(R"({"id":2,"name":"bob"})", jsr.get_object_result());
+        ASSERT_EQ(
+            sqlw::status::Condition::DONE,
+            query("SELECT * FROM user WHERE id = 2 LIMIT 1", jsr));
+
+        const std::string json = jsr.get_object_result();
+        ASSERT_EQ(R"({"id":2,"name":"bob"})", json);
     }
 }
+
+TEST_F(JsonStringResultTest, is_filled_by_sqlite3_exec)
+{
+    sqlw::JsonStringResult jsr;
+
+    ASSERT_EQ(
+        SQLITE_OK,
+        sqlite3_exec(
+            con.handle(),
+            "SELECT * FROM user",
+            &sqlw::JsonStringResult::callback,
+            &jsr,
+            nullptr));
+    ASSERT_EQ(
+        R"([{"id":1,"name":"john"},{"id":2,"name":"bob"}])",
+        jsr.get_array_result());
+}
+
+TEST_F(JsonStringResultTest, allocates_from_memory_resource)
+{
+    std::array<std::byte, 1024> storage;
+    std::pmr::monotonic_buffer_resource arena{
+        storage.data(),
+        storage.size(),
+        std::pmr::null_memory_resource()};
+
+    sqlw::JsonStringResult jsr{&arena};
+
+    ASSERT_EQ(sqlw::status::Condition::DONE, query("SELECT * FROM user", jsr));
+
+    const auto json = jsr.get_array_result(&arena);
+    ASSERT_EQ(&arena, json.get_allocator().resource());
+    ASSERT_EQ(R"([{"id":1,"name":"john"},{"id":2,"name":"bob"}])", json);
+}
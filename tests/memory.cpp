@@ -0,0 +1,294 @@
+#include "sqlw/memory.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/**
+ * Configures SQLite before its initialization and uses it, returning
+ * the number of the first step that failed or 0. Runs in a child process
+ * of a death test, where SQLite is still uninitialized.
+ */
+static int configure_fresh_process()
+{
+    static std::array<std::byte, 256 * 1024> page_cache;
+
+    if (sqlw::status::Condition::OK != sqlw::memory::use_pool_allocator())
+    {
+        return 1;
+    }
+
+    if (sqlw::status::Condition::OK !=
+        sqlw::memory::use_page_cache(page_cache, 4096))
+    {
+        return 2;
+    }
+
+    if (sqlw::status::Condition::OK !=
+        sqlw::memory::configure_mmap(1 << 20, 1 << 24))
+    {
+        return 3;
+    }
+
+    const auto path =
+        std::filesystem::temp_directory_path() / "test_memory_fresh.db";
+    std::remove(path.string().data());
+
+    const auto before = sqlw::memory::pool_stats().pooled_allocations;
+    sqlw::Connection con{path.string()};
+    sqlw::Statement stmt{&con};
+
+    if (sqlw::status::Condition::DONE !=
+        stmt("CREATE TABLE t (x); INSERT INTO t VALUES (randomblob(100))"))
+    {
+        return 4;
+    }
+
+    if (sqlw::memory::pool_stats().pooled_allocations <= before)
+    {
+        return 5;
+    }
+
+    if (1 << 20 != con.mmap_status().limit)
+    {
+        return 6;
+    }
+
+    con.close();
+    std::remove(path.string().data());
+
+    return 0;
+}
+
+TEST(MemoryPool, rounds_up_to_size_classes)
+{
+    const auto& methods = sqlw::memory::internal::pool_methods();
+
+    ASSERT_EQ(16, methods.xRoundup(1));
+    ASSERT_EQ(16, methods.xRoundup(16));
+    ASSERT_EQ(32, methods.xRoundup(17));
+    ASSERT_EQ(4096, methods.xRoundup(4000));
+    ASSERT_EQ(4104, methods.xRoundup(4097));
+}
+
+TEST(MemoryPool, allocates_reallocates_and_frees)
+{
+    const auto& methods = sqlw::memory::internal::pool_methods();
+    const auto before = sqlw::memory::pool_stats();
+
+    auto p = methods.xMalloc(100);
+    ASSERT_NE(nullptr, p);
+    ASSERT_EQ(128, methods.xSize(p));
+    std::memset(p, 'x', 100);
+
+    p = methods.xRealloc(p, methods.xRoundup(120));
+    ASSERT_EQ(128, methods.xSize(p));
+
+    p = methods.xRealloc(p, methods.xRoundup(10'000));
+    ASSERT_NE(nullptr, p);
+    ASSERT_EQ(10'000, methods.xSize(p));
+    ASSERT_EQ('x', static_cast<char*>(p)[99]);
+
+    methods.xFree(p);
+
+    const auto after = sqlw::memory::pool_stats();
+    ASSERT_EQ(before.pooled_allocations + 1, after.pooled_allocations);
+    ASSERT_EQ(before.large_allocations + 1, after.large_allocations);
+}
+
+TEST(MemoryPool, reuses_blocks_across_threads)
+{
+    const auto& methods = sqlw::memory::internal::pool_methods();
+    std::vector<void*> blocks(1000);
+
+    std::thread producer{[&]() {
+        for (auto& block : blocks)
+        {
+            block = methods.xMalloc(48);
+            std::memset(block, 0, 48);
+        }
+    }};
+    producer.join();
+
+    const auto slab_bytes = sqlw::memory::pool_stats().slab_bytes;
+
+    for (auto block : blocks)
+    {
+        methods.xFree(block);
+    }
+
+    for (auto& block : blocks)
+    {
+        block = methods.xMalloc(48);
+    }
+
+    for (auto block : blocks)
+    {
+        methods.xFree(block);
+    }
+
+    ASSERT_EQ(slab_bytes, sqlw::memory::pool_stats().slab_bytes);
+}
+
+TEST(MemoryPool, keeps_thread_cache_when_another_thread_exits)
+{
+    const auto& methods = sqlw::memory::internal::pool_methods();
+    void* cached = nullptr;
+    void* reused = nullptr;
+
+    std::thread worker{[&]() {
+        cached = methods.xMalloc(200);
+        methods.xFree(cached);
+
+        void* held = nullptr;
+        std::thread short_lived{[&]() { held = methods.xMalloc(200); }};
+        short_lived.join();
+
+        // Still served from this thread's cache, not the shared free list.
+        reused = methods.xMalloc(200);
+        methods.xFree(reused);
+        methods.xFree(held);
+    }};
+    worker.join();
+
+    ASSERT_EQ(cached, reused);
+}
+
+TEST(Memory, sets_heap_limits)
+{
+    const auto soft = sqlw::memory::set_soft_heap_limit(-1);
+    const auto hard = sqlw::memory::set_hard_heap_limit(-1);
+
+    sqlw::memory::set_soft_heap_limit(64 << 20);
+    ASSERT_EQ(64 << 20, sqlw::memory::set_soft_heap_limit(-1));
+
+    sqlw::memory::set_hard_heap_limit(128 << 20);
+    ASSERT_EQ(128 << 20, sqlw::memory::set_hard_heap_limit(-1));
+
+    sqlw::memory::set_soft_heap_limit(soft);
+    sqlw::memory::set_hard_heap_limit(hard);
+}
+
+TEST(Memory, releases_memory_of_open_connections)
+{
+    const auto count = sqlw::memory::connection_count();
+
+    {
+        sqlw::Connection first{":memory:"};
+        sqlw::Connection second{":memory:"};
+        ASSERT_EQ(count + 2, sqlw::memory::connection_count());
+
+        ASSERT_EQ(sqlw::status::Condition::OK, sqlw::memory::release_memory());
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            sqlw::memory::release_memory(&first));
+    }
+
+    ASSERT_EQ(count, sqlw::memory::connection_count());
+}
+
+TEST(Memory, skips_connections_without_mutex)
+{
+    const auto path =
+        std::filesystem::temp_directory_path() / "test_memory.db";
+    std::remove(path.string().data());
+
+    {
+        sqlw::Connection con{path.string()};
+        sqlw::Statement stmt{&con};
+        ASSERT_EQ(
+            sqlw::status::Condition::DONE,
+            stmt("CREATE TABLE t (x);"
+                 "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 "
+                 "FROM n WHERE i < 2000) "
+                 "INSERT INTO t SELECT randomblob(200) FROM n"));
+    }
+
+    sqlw::Connection locked{path.string()};
+    sqlw::Connection unlocked{
+        path.string(),
+        SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX};
+
+    for (auto con : {&locked, &unlocked})
+    {
+        std::vector<std::tuple<int64_t>> rows;
+        ASSERT_EQ(
+            sqlw::status::Condition::DONE,
+            sqlw::Statement{con}.query_as("SELECT count(*) FROM t", rows));
+    }
+
+    const auto unlocked_cache = unlocked.db_status().cache_used;
+    ASSERT_GT(locked.db_status().cache_used, 0);
+    ASSERT_GT(unlocked_cache, 0);
+
+    ASSERT_EQ(sqlw::status::Condition::OK, sqlw::memory::release_memory());
+    ASSERT_EQ(unlocked_cache, unlocked.db_status().cache_used);
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::memory::release_memory(&unlocked));
+    ASSERT_LT(unlocked.db_status().cache_used, unlocked_cache);
+
+    std::remove(path.string().data());
+}
+
+TEST(Memory, rejects_configuration_after_initialization)
+{
+    sqlw::Connection con{":memory:"};
+
+    ASSERT_EQ(
+        sqlw::status::Code{SQLITE_MISUSE},
+        sqlw::memory::use_pool_allocator());
+}
+
+TEST(MemoryDeathTest, configures_fresh_process)
+{
+    // Re-executes the binary, so the child starts without SQLite set up.
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+    ASSERT_EXIT(
+        std::exit(configure_fresh_process()),
+        testing::ExitedWithCode(0),
+        "");
+}
+
+#ifdef SQLITE_ENABLE_MEMSYS5
+static int allocate_from_heap()
+{
+    static std::array<std::byte, 4 << 20> heap;
+
+    if (sqlw::status::Condition::OK != sqlw::memory::use_heap(heap))
+    {
+        return 1;
+    }
+
+    sqlw::Connection con{":memory:"};
+    sqlw::Statement stmt{&con};
+
+    if (sqlw::status::Condition::DONE != stmt("CREATE TABLE t (x)"))
+    {
+        return 2;
+    }
+
+    return sqlw::memory::used() > 0 ? 0 : 3;
+}
+
+TEST(MemoryDeathTest, allocates_from_heap)
+{
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+    ASSERT_EXIT(
+        std::exit(allocate_from_heap()),
+        testing::ExitedWithCode(0),
+        "");
+}
+#endif
@@ -0,0 +1,159 @@
+#include "sqlw/parallel_scan.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class ParallelScanTest : public testing::Test
+{
+  protected:
+    static void SetUpTestSuite()
+    {
+        std::remove(path.string().data());
+
+        sqlw::Connection con{path.string()};
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("PRAGMA journal_mode = WAL;"
+                 "CREATE TABLE item (id INTEGER PRIMARY KEY, value INTEGER);"
+                 "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 "
+                 "FROM n WHERE i < 10000) "
+                 "INSERT INTO item SELECT i, (i * 7919) % 1000 FROM n;"
+                 "CREATE TABLE sparse (id INTEGER PRIMARY KEY);"
+                 "INSERT INTO sparse VALUES (-9223372036854775808), (-1), "
+                 "(0), (9223372036854775807)"));
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::remove(path.string().data());
+        std::remove((path.string() + "-wal").data());
+        std::remove((path.string() + "-shm").data());
+    }
+
+    static inline std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_parallel_scan.db";
+};
+
+TEST_F(ParallelScanTest, splits_rowid_range)
+{
+    sqlw::ParallelScan scan{path.string(), 2};
+    ASSERT_EQ(sqlw::status::Condition::OK, scan.status());
+
+    const auto partitions = scan.rowid_partitions("item", 3);
+
+    ASSERT_EQ(3, partitions.size());
+    ASSERT_EQ(1, partitions.front().first);
+    ASSERT_EQ(10000, partitions.back().last);
+
+    for (size_t i = 1; i < partitions.size(); i++)
+    {
+        ASSERT_EQ(partitions[i - 1].last + 1, partitions[i].first);
+    }
+
+    ASSERT_TRUE(scan.rowid_partitions("missing", 3).empty());
+}
+
+TEST_F(ParallelScanTest, splits_full_int64_rowid_range)
+{
+    sqlw::ParallelScan scan{path.string(), 2};
+    const auto partitions = scan.rowid_partitions("sparse", 4);
+
+    ASSERT_EQ(4, partitions.size());
+    ASSERT_EQ(INT64_MIN, partitions.front().first);
+    ASSERT_EQ(INT64_MAX, partitions.back().last);
+
+    for (size_t i = 1; i < partitions.size(); i++)
+    {
+        ASSERT_LT(partitions[i - 1].first, partitions[i - 1].last);
+        ASSERT_EQ(partitions[i - 1].last + 1, partitions[i].first);
+    }
+
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        scan.query_as(
+            "SELECT id FROM sparse WHERE id BETWEEN ? AND ?",
+            partitions,
+            rows));
+    ASSERT_EQ(4, rows.size());
+}
+
+TEST_F(ParallelScanTest, concatenates_partitions)
+{
+    sqlw::ParallelScan scan{path.string(), 4};
+    const auto partitions = scan.rowid_partitions("item", 16);
+
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        scan.query_as(
+            "SELECT id FROM item WHERE id BETWEEN ? AND ? ORDER BY id",
+            partitions,
+            rows));
+
+    ASSERT_EQ(10000, rows.size());
+
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        ASSERT_EQ(i + 1, std::get<0>(rows[i]));
+    }
+}
+
+TEST_F(ParallelScanTest, merges_ordered_partitions)
+{
+    sqlw::ParallelScan scan{path.string(), 3};
+    const auto partitions = scan.rowid_partitions("item", 7);
+
+    std::vector<std::tuple<int64_t, int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        scan.query_as_merged(
+            "SELECT value, id FROM item WHERE id BETWEEN ? AND ? "
+            "ORDER BY value, id",
+            partitions,
+            rows,
+            [](const auto& a, const auto& b) { return a < b; }));
+
+    ASSERT_EQ(10000, rows.size());
+    ASSERT_TRUE(std::is_sorted(rows.begin(), rows.end()));
+}
+
+TEST_F(ParallelScanTest, combines_partial_aggregates)
+{
+    sqlw::ParallelScan scan{path.string(), 4};
+    const auto partitions = scan.rowid_partitions("item", 8);
+
+    int64_t sum = 0;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        scan.reduce<std::tuple<int64_t>>(
+            "SELECT sum(id) FROM item WHERE id BETWEEN ? AND ?",
+            partitions,
+            sum,
+            [](int64_t& total, std::vector<std::tuple<int64_t>>&& rows) {
+                total += std::get<0>(rows.at(0));
+            }));
+
+    ASSERT_EQ(50005000, sum);
+}
+
+TEST_F(ParallelScanTest, reports_query_errors)
+{
+    sqlw::ParallelScan scan{path.string(), 2};
+    const std::vector<sqlw::Partition> partitions{{1, 10}};
+
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::ERROR,
+        scan.query_as("SELECT nope FROM item", partitions, rows));
+}
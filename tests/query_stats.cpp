@@ -0,0 +1,109 @@
+#include "sqlw/query_stats.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <tuple>
+
+TEST(QueryStats, fingerprint_strips_literals)
+{
+    ASSERT_EQ(
+        "select * from user where id = ? and name = ?",
+        sqlw::QueryStats::fingerprint(
+            "SELECT *  FROM user\n WHERE id = 42 AND name = 'it''s' -- c"));
+    ASSERT_EQ(
+        "select \"Id\" from user where id in (?) limit ?",
+        sqlw::QueryStats::fingerprint(
+            "select \"Id\" from user /* x */ "
+            "where id IN (1, 2,3) LIMIT :lim;"));
+    ASSERT_EQ(
+        "insert into t values (?)",
+        sqlw::QueryStats::fingerprint(
+            "INSERT INTO t VALUES (?1, x'ff', -1.5e+3, $v)"));
+}
+
+TEST(QueryStats, histogram_percentiles)
+{
+    sqlw::Histogram h;
+
+    for (uint64_t i = 1; i <= 1000; i++)
+    {
+        h.record(i * 1000);
+    }
+
+    ASSERT_EQ(1000, h.count());
+    ASSERT_EQ(1'000'000, h.max());
+    ASSERT_NEAR(500'000, h.percentile(50), 500'000 / 8);
+    ASSERT_NEAR(990'000, h.percentile(99), 990'000 / 8);
+    ASSERT_EQ(1'000'000, h.percentile(100));
+
+    for (uint64_t v : {0ull, 7ull, 8ull, 1000ull, ~0ull})
+    {
+        ASSERT_GE(
+            sqlw::Histogram::bucket_upper_bound(
+                sqlw::Histogram::bucket_index(v)),
+            v);
+    }
+}
+
+TEST(QueryStats, collects_statistics_by_fingerprint)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::QueryStats stats;
+
+    ASSERT_TRUE(sqlw::status::Condition::OK == stats.attach(&con));
+    ASSERT_EQ(&stats, con.query_stats());
+
+    {
+        sqlw::Statement stmt{&con};
+        stmt("CREATE TABLE user (id INTEGER PRIMARY KEY, name TEXT)");
+    }
+
+    for (int i = 0; i < 5; i++)
+    {
+        sqlw::Statement stmt{&con};
+        stmt(
+            "INSERT INTO user (id, name) VALUES (?1, 'name')",
+            std::tuple{i});
+    }
+
+    auto worker = std::thread{[&]() {
+        sqlw::Statement stmt{&con};
+        stmt("SELECT * FROM user WHERE id < 3");
+    }};
+    worker.join();
+
+    {
+        sqlw::Statement stmt{&con};
+        stmt("SELECT * FROM user WHERE id < 10");
+    }
+
+    auto snapshot = stats.snapshot();
+
+    auto find = [&](std::string_view fingerprint) {
+        return std::find_if(
+            snapshot.begin(), snapshot.end(), [&](const auto& e) {
+                return e.fingerprint == fingerprint;
+            });
+    };
+
+    const auto insert = find("insert into user (id, name) values (?)");
+    ASSERT_NE(snapshot.end(), insert);
+    ASSERT_EQ(5, insert->calls);
+    ASSERT_EQ(5, insert->prepare_ns.count());
+    ASSERT_EQ(5, insert->step_ns.count());
+
+    const auto select = find("select * from user where id < ?");
+    ASSERT_NE(snapshot.end(), select);
+    ASSERT_EQ(2, select->calls);
+    ASSERT_EQ(8, select->rows);
+
+    stats.reset();
+    snapshot = stats.snapshot();
+    ASSERT_EQ(0, find("select * from user where id < ?")->calls);
+
+    stats.detach(&con);
+    ASSERT_EQ(nullptr, con.query_stats());
+}
@@ -0,0 +1,162 @@
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/result_cache.hpp"
+#include "sqlw/statement.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+class ResultCacheTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::remove(path.string().data());
+        con.connect(path.string());
+
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, "
+                 "price REAL, tag BLOB);"
+                 "INSERT INTO item VALUES (1, 'apple', 1.5, x'0102'), "
+                 "(2, 'pear', 2.0, NULL)"));
+    }
+
+    void TearDown() override
+    {
+        con.close();
+        std::remove(path.string().data());
+    }
+
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_result_cache.db";
+    sqlw::Connection con;
+};
+
+TEST_F(ResultCacheTest, materializes_rows)
+{
+    sqlw::ResultCache cache{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> result;
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        cache.query("SELECT * FROM item ORDER BY id", result));
+
+    ASSERT_EQ(2, result->rows());
+    ASSERT_EQ(
+        (std::vector<std::string>{"id", "name", "price", "tag"}),
+        result->columns());
+    ASSERT_EQ(sqlw::Type::SQL_INT, result->type(0, 0));
+    ASSERT_EQ(2, result->int64(1, 0));
+    ASSERT_EQ("pear", result->text(1, 1));
+    ASSERT_EQ(1.5, result->real(0, 2));
+    ASSERT_EQ("\x01\x02", result->text(0, 3));
+    ASSERT_EQ(sqlw::Type::SQL_NULL, result->type(1, 3));
+    ASSERT_TRUE(result->text(1, 0).empty());
+    ASSERT_TRUE(result->text(0, 2).empty());
+    ASSERT_TRUE(result->text(1, 3).empty());
+}
+
+TEST_F(ResultCacheTest, hits_until_data_changes)
+{
+    sqlw::ResultCache cache{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> first;
+    std::shared_ptr<const sqlw::ResultCache::Result> second;
+    const std::vector<sqlw::Statement::bindable_t> params{
+        {"1", sqlw::Type::SQL_INT}};
+
+    cache.query("SELECT name FROM item WHERE id = ?", first, params);
+    cache.query("SELECT name FROM item WHERE id = ?", second, params);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(1, cache.stats().hits);
+    ASSERT_EQ(1, cache.stats().misses);
+    ASSERT_EQ(0.5, cache.stats().hit_rate());
+
+    const std::vector<sqlw::Statement::bindable_t> other{
+        {"2", sqlw::Type::SQL_INT}};
+    cache.query("SELECT name FROM item WHERE id = ?", second, other);
+    ASSERT_EQ("pear", second->text(0, 0));
+    ASSERT_EQ(2, cache.stats().entries);
+
+    sqlw::Statement stmt{&con};
+    stmt("UPDATE item SET name = 'plum' WHERE id = 1");
+
+    cache.query("SELECT name FROM item WHERE id = ?", second, params);
+    ASSERT_NE(first, second);
+    ASSERT_EQ("plum", second->text(0, 0));
+    ASSERT_EQ("apple", first->text(0, 0));
+    ASSERT_EQ(1, cache.stats().stale);
+}
+
+TEST_F(ResultCacheTest, sees_writes_of_other_connections)
+{
+    sqlw::ResultCache cache{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> result;
+
+    cache.query("SELECT count(*) FROM item", result);
+    ASSERT_EQ(2, result->int64(0, 0));
+
+    sqlw::Connection writer{path.string()};
+    sqlw::Statement stmt{&writer};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("INSERT INTO item (id) VALUES (3)"));
+
+    cache.query("SELECT count(*) FROM item", result);
+    ASSERT_EQ(3, result->int64(0, 0));
+    ASSERT_EQ(0, cache.stats().hits);
+}
+
+TEST_F(ResultCacheTest, evicts_least_recently_used)
+{
+    sqlw::ResultCache probe{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> result;
+    probe.query("SELECT 1", result);
+    const size_t entry = probe.stats().bytes;
+
+    sqlw::ResultCache cache{&con, entry * 2 + entry / 2};
+    cache.query("SELECT 1", result);
+    cache.query("SELECT 2", result);
+    cache.query("SELECT 1", result);
+    cache.query("SELECT 3", result);
+
+    ASSERT_EQ(2, cache.stats().entries);
+    ASSERT_EQ(1, cache.stats().evictions);
+    ASSERT_LE(cache.stats().bytes, entry * 2 + entry / 2);
+
+    cache.query("SELECT 1", result);
+    ASSERT_EQ(2, cache.stats().hits);
+}
+
+TEST_F(ResultCacheTest, does_not_cache_writes)
+{
+    sqlw::ResultCache cache{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> result;
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        cache.query("INSERT INTO item (id) VALUES (3) RETURNING id", result));
+    ASSERT_EQ(3, result->int64(0, 0));
+    ASSERT_EQ(0, cache.stats().entries);
+}
+
+TEST_F(ResultCacheTest, always_runs_transaction_control)
+{
+    sqlw::ResultCache cache{&con, 1 << 20};
+    std::shared_ptr<const sqlw::ResultCache::Result> result;
+
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(sqlw::status::Condition::OK, cache.query("BEGIN", result));
+        ASSERT_EQ(0, sqlite3_get_autocommit(con.handle()));
+        ASSERT_EQ(sqlw::status::Condition::OK, cache.query("COMMIT", result));
+        ASSERT_NE(0, sqlite3_get_autocommit(con.handle()));
+    }
+
+    ASSERT_EQ(0, cache.stats().entries);
+    ASSERT_EQ(0, cache.stats().hits);
+}
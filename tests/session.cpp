@@ -0,0 +1,176 @@
+#include "sqlw/session.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include "sqlw/transaction.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifdef SQLITE_ENABLE_SESSION
+
+class SessionTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        constexpr auto schema =
+            "CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)";
+
+        sqlw::Statement stmt{&primary};
+        ASSERT_EQ(sqlw::status::Condition::OK, stmt(schema));
+
+        stmt = sqlw::Statement{&standby};
+        ASSERT_EQ(sqlw::status::Condition::OK, stmt(schema));
+    }
+
+    static auto items(sqlw::Connection& con)
+        -> std::vector<std::tuple<int64_t, std::string>>
+    {
+        std::vector<std::tuple<int64_t, std::string>> rows;
+        sqlw::Statement stmt{&con};
+        stmt.query_as("SELECT id, name FROM item ORDER BY id", rows);
+
+        return rows;
+    }
+
+    sqlw::Connection primary{":memory:"};
+    sqlw::Connection standby{":memory:"};
+};
+
+TEST_F(SessionTest, replicates_transactions)
+{
+    sqlw::Session session{&primary};
+    ASSERT_EQ(sqlw::status::Condition::OK, session.attach());
+    ASSERT_TRUE(session.empty());
+
+    sqlw::Transaction transaction{&primary};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        transaction("INSERT INTO item VALUES (1, 'apple'), (2, 'pear');"
+                    "UPDATE item SET name = 'plum' WHERE id = 2;"));
+    ASSERT_FALSE(session.empty());
+
+    std::vector<std::byte> changeset;
+    ASSERT_EQ(sqlw::status::Condition::OK, session.take(changeset));
+    ASSERT_TRUE(session.empty());
+    ASSERT_FALSE(changeset.empty());
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            changeset,
+            sqlw::Session::ConflictPolicy::ABORT));
+    ASSERT_EQ(items(primary), items(standby));
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        transaction("DELETE FROM item WHERE id = 1"));
+
+    changeset.clear();
+    ASSERT_EQ(sqlw::status::Condition::OK, session.take(changeset));
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            changeset,
+            sqlw::Session::ConflictPolicy::ABORT));
+
+    const auto rows = items(standby);
+    ASSERT_EQ(1, rows.size());
+    ASSERT_EQ(std::tuple(2, "plum"), rows[0]);
+}
+
+TEST_F(SessionTest, streams_changesets_through_a_file)
+{
+    sqlw::Session session{&primary, sqlw::Session::Format::PATCHSET};
+    ASSERT_EQ(sqlw::status::Condition::OK, session.attach("item"));
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+    const int fd = fileno(file);
+
+    sqlw::Transaction transaction{&primary};
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            transaction("INSERT INTO item (name) VALUES (?)", std::tuple{i}));
+        ASSERT_EQ(sqlw::status::Condition::OK, session.take(fd));
+    }
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        transaction("UPDATE item SET name = 'last' WHERE id = 3"));
+    ASSERT_EQ(sqlw::status::Condition::OK, session.take(fd));
+
+    std::rewind(file);
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            fd,
+            sqlw::Session::ConflictPolicy::ABORT));
+    std::fclose(file);
+
+    ASSERT_EQ(3, items(standby).size());
+    ASSERT_EQ(items(primary), items(standby));
+}
+
+TEST_F(SessionTest, resolves_conflicts_by_policy)
+{
+    sqlw::Statement stmt{&standby};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("INSERT INTO item VALUES (1, 'standby')"));
+
+    sqlw::Session session{&primary};
+    ASSERT_EQ(sqlw::status::Condition::OK, session.attach());
+
+    stmt = sqlw::Statement{&primary};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("INSERT INTO item VALUES (1, 'primary'), (2, 'pear')"));
+
+    std::vector<std::byte> changeset;
+    ASSERT_EQ(sqlw::status::Condition::OK, session.take(changeset));
+
+    ASSERT_NE(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            changeset,
+            sqlw::Session::ConflictPolicy::ABORT));
+    ASSERT_EQ(1, items(standby).size());
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            changeset,
+            sqlw::Session::ConflictPolicy::OMIT));
+    ASSERT_EQ(std::tuple(1, "standby"), items(standby)[0]);
+    ASSERT_EQ(2, items(standby).size());
+
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::Session::apply(
+            &standby,
+            changeset,
+            sqlw::Session::ConflictPolicy::REPLACE));
+    ASSERT_EQ(items(primary), items(standby));
+}
+
+#else
+
+TEST(Session, requires_session_extension)
+{
+    GTEST_SKIP() << "SQLite is built without the session extension";
+}
+
+#endif // SQLITE_ENABLE_SESSION
@@ -0,0 +1,130 @@
+#include "sqlw/slow_query_log.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/ring_buffer.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+TEST(RingBuffer, pushes_and_pops_across_threads)
+{
+    sqlw::RingBuffer<int> ring{1000};
+    ASSERT_EQ(1024, ring.capacity());
+
+    constexpr int per_producer = 10'000;
+    std::atomic<int64_t> sum{0};
+    std::atomic<int> popped{0};
+
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < 2; p++)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= per_producer; i++)
+            {
+                int v = i;
+                while (!ring.try_push(std::move(v)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (int c = 0; c < 2; c++)
+    {
+        threads.emplace_back([&]() {
+            int v;
+            while (popped.load() < 2 * per_producer)
+            {
+                if (ring.try_pop(v))
+                {
+                    sum += v;
+                    popped++;
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    ASSERT_EQ(2 * (int64_t{per_producer} * (per_producer + 1) / 2), sum);
+
+    int v;
+    ASSERT_FALSE(ring.try_pop(v));
+}
+
+TEST(SlowQueryLog, captures_slow_statements_with_plan)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::SlowQueryLog log{std::chrono::hours{1}};
+    log.attach(&con);
+    ASSERT_EQ(&log, con.slow_query_log());
+
+    sqlw::Statement stmt{&con};
+    stmt("CREATE TABLE user (id INTEGER PRIMARY KEY, name TEXT);"
+         "INSERT INTO user VALUES (1, 'kate'), (2, 'eris')");
+
+    ASSERT_TRUE(log.drain().empty());
+
+    log.set_threshold(std::chrono::nanoseconds{0});
+    stmt(
+        "SELECT * FROM user WHERE name = ?1; SELECT * FROM user WHERE id = 2",
+        std::array<sqlw::Statement::bindable_t, 1>{
+            {{"eris", sqlw::Type::SQL_TEXT}}});
+
+    const auto entries = log.drain();
+    ASSERT_EQ(2, entries.size());
+    ASSERT_EQ("SELECT * FROM user WHERE name = ?1;", entries[0].sql);
+    ASSERT_EQ(
+        "SELECT * FROM user WHERE name = 'eris';", entries[0].expanded_sql);
+    ASSERT_EQ(1, entries[0].parameter_count);
+    ASSERT_EQ(1, entries[0].plan.size());
+    ASSERT_EQ("SCAN user", entries[0].plan[0]);
+    ASSERT_EQ("SELECT * FROM user WHERE id = 2", entries[1].sql);
+    ASSERT_EQ(
+        "SEARCH user USING INTEGER PRIMARY KEY (rowid=?)", entries[1].plan[0]);
+
+    log.detach(&con);
+    stmt("SELECT 1");
+    ASSERT_TRUE(log.drain().empty());
+}
+
+TEST(SlowQueryLog, drops_entries_when_full)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::SlowQueryLog log{std::chrono::nanoseconds{0}, 2};
+    log.attach(&con);
+
+    for (int i = 0; i < 5; i++)
+    {
+        sqlw::Statement stmt{&con};
+        stmt("SELECT 1");
+    }
+
+    ASSERT_EQ(3, log.dropped());
+    ASSERT_EQ(2, log.drain().size());
+}
+
+TEST(SlowQueryLog, detaches_on_close)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::SlowQueryLog log{std::chrono::nanoseconds{0}};
+    log.attach(&con);
+
+    con.close();
+    ASSERT_EQ(nullptr, con.slow_query_log());
+
+    con.connect(":memory:");
+    sqlw::Statement stmt{&con};
+    stmt("SELECT 1");
+    ASSERT_TRUE(log.drain().empty());
+}
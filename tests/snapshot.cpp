@@ -0,0 +1,110 @@
+#include "sqlw/snapshot.hpp"
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/statement.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class SnapshotTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&source};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);"
+                 "INSERT INTO item (name) VALUES ('a'), ('b'), ('c')"));
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.string().data());
+    }
+
+    static std::string names(sqlw::Connection& con)
+    {
+        sqlw::Statement stmt{&con};
+        std::string value;
+
+        stmt(
+            "SELECT group_concat(name, ',') FROM item",
+            [&](sqlw::Statement::ExecArgs args) {
+                value = args.column_value;
+            });
+
+        return value;
+    }
+
+    sqlw::Connection source{":memory:"};
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_snapshot.db";
+};
+
+TEST_F(SnapshotTest, round_trips_through_buffer)
+{
+    std::vector<std::byte> image;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::snapshot::serialize(&source, image));
+    ASSERT_FALSE(image.empty());
+
+    sqlw::Connection copy{":memory:"};
+    ASSERT_EQ(sqlw::status::Condition::OK, sqlw::snapshot::load(&copy, image));
+    ASSERT_EQ("a,b,c", names(copy));
+
+    sqlw::Statement stmt{&copy};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt("INSERT INTO item (name) VALUES ('d')"));
+    ASSERT_EQ("a,b,c,d", names(copy));
+}
+
+TEST_F(SnapshotTest, round_trips_through_file)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::snapshot::save(&source, path.string()));
+
+    sqlw::Connection copy{":memory:"};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::snapshot::load_file(&copy, path.string()));
+    ASSERT_EQ("a,b,c", names(copy));
+}
+
+TEST_F(SnapshotTest, loads_mapped_file_read_only)
+{
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::snapshot::save(&source, path.string()));
+
+    sqlw::snapshot::Mapping mapping;
+    ASSERT_FALSE(mapping.open(path.string()));
+
+    sqlw::Connection copy{":memory:"};
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        sqlw::snapshot::load_mapped(&copy, mapping));
+    ASSERT_EQ("a,b,c", names(copy));
+
+    sqlw::Statement stmt{&copy};
+    ASSERT_EQ(
+        sqlw::status::Code{SQLITE_READONLY},
+        stmt("INSERT INTO item (name) VALUES ('d')"));
+}
+
+TEST_F(SnapshotTest, reports_missing_file)
+{
+    sqlw::snapshot::Mapping mapping;
+    ASSERT_EQ(
+        std::errc::no_such_file_or_directory,
+        mapping.open(path.string()));
+
+    sqlw::Connection copy{":memory:"};
+    ASSERT_TRUE(sqlw::snapshot::load_file(&copy, path.string()));
+}
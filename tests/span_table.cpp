@@ -0,0 +1,159 @@
+#include "sqlw/connection.hpp"
+#include "sqlw/forward.hpp"
+#include "sqlw/span_table.hpp"
+#include "sqlw/statement.hpp"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+struct Price
+{
+    int64_t id;
+    std::string_view name;
+    double price;
+};
+} // namespace
+
+template <> struct sqlw::row::column_names<Price>
+{
+    static constexpr std::array<std::string_view, 3> value{
+        "id",
+        "name",
+        "price"};
+};
+
+class SpanTableTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+
+        ASSERT_EQ(
+            sqlw::status::Condition::OK,
+            stmt("CREATE TABLE orders (id INTEGER PRIMARY KEY, item INTEGER);"
+                 "INSERT INTO orders VALUES (1, 10), (2, 20), (3, 30), "
+                 "(4, 20)"));
+    }
+
+    auto plan(std::string_view sql) -> std::string
+    {
+        sqlw::Statement stmt{&con};
+        std::vector<std::tuple<int64_t, int64_t, int64_t, std::string>> rows;
+        stmt.query_as("EXPLAIN QUERY PLAN " + std::string{sql}, rows);
+
+        std::string result;
+
+        for (const auto& row : rows)
+        {
+            result += std::get<3>(row) + "\n";
+        }
+
+        return result;
+    }
+
+    sqlw::Connection con{":memory:"};
+    const std::vector<Price> prices{
+        {10, "apple", 1.5},
+        {20, "pear", 2.0},
+        {25, "plum", 0.5},
+        {30, "fig", 3.0}};
+};
+
+TEST_F(SpanTableTest, joins_caller_rows)
+{
+    sqlw::SpanTable<Price> table{&con, "prices", prices, 0};
+    ASSERT_EQ(sqlw::status::Condition::OK, table.status());
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<int64_t, std::string, double>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as(
+            "SELECT o.id, p.name, p.price FROM orders o "
+            "JOIN prices p ON p.id = o.item ORDER BY o.id",
+            rows));
+
+    const std::vector<std::tuple<int64_t, std::string, double>> expected{
+        {1, "apple", 1.5},
+        {2, "pear", 2.0},
+        {3, "fig", 3.0},
+        {4, "pear", 2.0}};
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(SpanTableTest, searches_sorted_column)
+{
+    sqlw::SpanTable<Price> table{&con, "prices", prices, 0};
+
+    const auto ids = [&](std::string_view where) {
+        sqlw::Statement stmt{&con};
+        std::vector<std::tuple<int64_t>> rows;
+        stmt.query_as(
+            "SELECT id FROM prices WHERE " + std::string{where},
+            rows);
+
+        std::vector<int64_t> result;
+
+        for (const auto& [id] : rows)
+        {
+            result.push_back(id);
+        }
+
+        return result;
+    };
+
+    ASSERT_EQ(std::vector<int64_t>{20}, ids("id = 20"));
+    ASSERT_EQ(std::vector<int64_t>{}, ids("id = 21"));
+    ASSERT_EQ(std::vector<int64_t>{20}, ids("id = '20'"));
+    ASSERT_EQ((std::vector<int64_t>{25, 30}), ids("id > 20"));
+    ASSERT_EQ((std::vector<int64_t>{20, 25}), ids("id >= 20 AND id < 30"));
+    ASSERT_EQ((std::vector<int64_t>{10, 20}), ids("id <= 20.5"));
+    ASSERT_EQ(std::vector<int64_t>{}, ids("id > NULL"));
+    ASSERT_EQ(std::vector<int64_t>{25}, ids("rowid = 2"));
+
+    ASSERT_NE(std::string::npos, plan("SELECT * FROM prices WHERE id = 5")
+                                     .find("VIRTUAL TABLE INDEX 1:"));
+    ASSERT_EQ(
+        std::string::npos,
+        plan("SELECT * FROM prices ORDER BY id").find("ORDER BY"));
+}
+
+TEST_F(SpanTableTest, exposes_single_values)
+{
+    const std::vector<std::optional<int64_t>> items{std::nullopt, 20, 30};
+    sqlw::SpanTable<std::optional<int64_t>> table{&con, "items", items, 0};
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as(
+            "SELECT id FROM orders WHERE item IN (SELECT value FROM items) "
+            "ORDER BY id",
+            rows));
+
+    const std::vector<std::tuple<int64_t>> expected{{2}, {3}, {4}};
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(SpanTableTest, is_empty_after_destruction)
+{
+    {
+        sqlw::SpanTable<Price> table{&con, "prices", prices};
+    }
+
+    sqlw::Statement stmt{&con};
+    std::vector<std::tuple<int64_t>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::OK,
+        stmt.query_as("SELECT count(*) FROM prices", rows));
+    ASSERT_EQ(0, std::get<0>(rows.at(0)));
+}
@@ -3,10 +3,14 @@
 #include "sqlw/forward.hpp"
 #include "gtest/gtest.h"
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <system_error>
 #include <tuple>
+#include <vector>
 
 static void errorLogCallback(void* _, int iErrCode, const char* zMsg)
 {
@@ -917,3 +921,268 @@ INSTANTIATE_TEST_SUITE_P(
     [](const testing::TestParamInfo<StatementTest::ParamType>& info) {
         return std::string{std::get<0>(info.param)};
     });
+
+struct UserRow
+{
+    int64_t id;
+    std::string name;
+    std::optional<double> score;
+};
+
+struct NamedUserRow
+{
+    std::string name;
+    int id;
+};
+
+template <> struct sqlw::row::column_names<NamedUserRow>
+{
+    static constexpr std::array<std::string_view, 2> value{"name", "id"};
+};
+
+struct PmrUserRow
+{
+    int64_t id;
+    std::pmr::string name;
+};
+
+class StatementQueryAsTest : public testing::Test
+{
+  protected:
+    sqlw::Connection con{":memory:"};
+
+    void SetUp() override
+    {
+        sqlw::Statement stmt{&con};
+        std::error_code ec = stmt(
+            "CREATE TABLE user (id INTEGER PRIMARY KEY, name TEXT, score REAL);"
+            "INSERT INTO user VALUES (1,'kate',1.5),(2,'eris',NULL),"
+            "(3,'bob',3.25)");
+        ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    }
+};
+
+TEST_F(StatementQueryAsTest, maps_rows_to_aggregate_positionally)
+{
+    sqlw::Statement stmt{&con};
+    std::vector<UserRow> rows;
+    rows.reserve(3);
+
+    std::error_code ec =
+        stmt.query_as("SELECT id, name, score FROM user ORDER BY id", rows);
+
+    ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    ASSERT_EQ(3, rows.size());
+    ASSERT_EQ(1, rows[0].id);
+    ASSERT_EQ("kate", rows[0].name);
+    ASSERT_DOUBLE_EQ(1.5, rows[0].score.value());
+    ASSERT_FALSE(rows[1].score.has_value());
+    ASSERT_EQ("bob", rows[2].name);
+}
+
+TEST_F(StatementQueryAsTest, maps_rows_to_aggregate_by_name)
+{
+    sqlw::Statement stmt{&con};
+    std::vector<NamedUserRow> rows;
+
+    std::error_code ec = stmt.query_as(
+        "SELECT score, id, name FROM user WHERE id > ?1 ORDER BY id",
+        rows,
+        std::tuple{1});
+
+    ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    ASSERT_EQ(2, rows.size());
+    ASSERT_EQ(2, rows[0].id);
+    ASSERT_EQ("eris", rows[0].name);
+    ASSERT_EQ(3, rows[1].id);
+}
+
+TEST_F(StatementQueryAsTest, maps_rows_to_tuple_in_pmr_vector)
+{
+    sqlw::Statement stmt{&con};
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::vector<std::tuple<int, std::string>> rows{&arena};
+
+    std::error_code ec = stmt.query_as(
+        "SELECT id, name FROM user WHERE name = ?1",
+        rows,
+        std::array<sqlw::Statement::bindable_t, 1>{
+            {{"eris", sqlw::Type::SQL_TEXT}}});
+
+    ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    ASSERT_EQ(1, rows.size());
+    ASSERT_EQ(2, std::get<0>(rows[0]));
+    ASSERT_EQ("eris", std::get<1>(rows[0]));
+}
+
+TEST_F(StatementQueryAsTest, allocates_aggregate_strings_from_vector_resource)
+{
+    sqlw::Statement stmt{&con};
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena{
+        buffer.data(),
+        buffer.size(),
+        std::pmr::null_memory_resource()};
+    std::pmr::vector<PmrUserRow> rows{&arena};
+
+    std::error_code ec = stmt.query_as(
+        "SELECT id, name || ' with a name too long for SSO' FROM user "
+        "ORDER BY id",
+        rows);
+
+    ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    ASSERT_EQ(3, rows.size());
+    ASSERT_EQ("eris with a name too long for SSO", rows[1].name);
+
+    for (const auto& row : rows)
+    {
+        ASSERT_EQ(&arena, row.name.get_allocator().resource());
+    }
+}
+
+TEST_F(StatementQueryAsTest, reports_mapping_error)
+{
+    sqlw::Statement stmt{&con};
+
+    std::vector<UserRow> rows;
+    std::error_code ec = stmt.query_as("SELECT id FROM user", rows);
+    ASSERT_EQ(sqlw::status::Code::MAPPING_ERROR, ec);
+    ASSERT_TRUE(rows.empty());
+
+    std::vector<NamedUserRow> named_rows;
+    ec = stmt.query_as("SELECT id, name AS n FROM user", named_rows);
+    ASSERT_EQ(sqlw::status::Code::MAPPING_ERROR, ec);
+}
+
+TEST(StatementCounters, reports_engine_counters)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::Statement stmt{&con};
+
+    stmt("CREATE TABLE t (a INTEGER, b TEXT);"
+         "INSERT INTO t VALUES (3,'c'),(1,'a'),(2,'b')");
+
+    stmt.prepare("SELECT * FROM t ORDER BY b");
+
+    while (sqlw::status::Condition::ROW == stmt.exec().status())
+    {
+    }
+
+    const auto counters = stmt.counters(true);
+    ASSERT_EQ(2, counters.fullscan_steps);
+    ASSERT_EQ(1, counters.sorts);
+    ASSERT_EQ(0, counters.autoindexes);
+    ASSERT_EQ(1, counters.runs);
+    ASSERT_GT(counters.vm_steps, 0);
+    ASSERT_GT(counters.memory_used, 0);
+
+    ASSERT_EQ(0, stmt.counters().sorts);
+}
+
+TEST(StatementCounters, fires_callback_past_thresholds)
+{
+    sqlw::Connection con{":memory:"};
+    std::vector<std::string> reported;
+
+    con.on_counters_exceeded(
+        {.autoindexes = 1},
+        [&](std::string_view sql, const sqlw::StatementCounters& counters) {
+            reported.emplace_back(sql);
+            ASSERT_GT(counters.autoindexes, 0);
+        });
+
+    sqlw::Statement stmt{&con};
+    stmt("CREATE TABLE a (x INTEGER);"
+         "CREATE TABLE b (y INTEGER);"
+         "INSERT INTO a VALUES (1),(2),(3);"
+         "INSERT INTO b VALUES (1),(2),(3);");
+
+    ASSERT_TRUE(reported.empty());
+
+    std::vector<std::tuple<int>> rows;
+    auto ec = stmt.query_as(
+        "SELECT a.x FROM a JOIN b ON b.y = a.x WHERE a.x > 0", rows);
+
+    ASSERT_TRUE(sqlw::status::Condition::DONE == ec) << ec;
+    ASSERT_EQ(3, rows.size());
+    ASSERT_EQ(1, reported.size());
+    ASSERT_EQ(
+        "SELECT a.x FROM a JOIN b ON b.y = a.x WHERE a.x > 0", reported[0]);
+
+    con.on_counters_exceeded({}, nullptr);
+    ASSERT_FALSE(con.has_counters_callback());
+}
+
+TEST(StatementCounters, swallows_callback_exceptions)
+{
+    sqlw::Connection con{":memory:"};
+    size_t calls = 0;
+
+    con.on_counters_exceeded(
+        {.vm_steps = 1},
+        [&](std::string_view, const sqlw::StatementCounters&) {
+            calls++;
+            throw std::runtime_error{"callback failed"};
+        });
+
+    sqlw::Statement stmt{&con};
+    ASSERT_EQ(
+        sqlw::status::Condition::DONE,
+        stmt("CREATE TABLE a (x INTEGER); INSERT INTO a VALUES (1)"));
+
+    std::vector<std::tuple<int>> rows;
+    ASSERT_EQ(
+        sqlw::status::Condition::DONE,
+        stmt.query_as("SELECT x FROM a", rows));
+    ASSERT_EQ(1, rows.size());
+    ASSERT_EQ(3, calls);
+}
+
+TEST(StatementColumnView, views_text_and_blob_columns)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::Statement stmt{&con};
+
+    stmt("CREATE TABLE t (a TEXT, b BLOB, c INTEGER);"
+         "INSERT INTO t VALUES ('text', x'00ff', 7)");
+
+    stmt.prepare("SELECT a, b, c FROM t").exec();
+    ASSERT_EQ(sqlw::status::Condition::ROW, stmt.status());
+
+    ASSERT_EQ("text", stmt.column_view(sqlw::Type::SQL_TEXT, 0));
+    ASSERT_EQ(
+        std::string_view("\x00\xff", 2),
+        stmt.column_view(sqlw::Type::SQL_BLOB, 1));
+    ASSERT_TRUE(stmt.column_view(sqlw::Type::SQL_INT, 2).empty());
+}
+
+TEST(StatementColumnValue, prints_numbers_like_streams)
+{
+    sqlw::Connection con{":memory:"};
+    sqlw::Statement stmt{&con};
+    constexpr auto sql = "SELECT 4294967296, 1.0 / 3, -2.5e-10, 'text', NULL";
+
+    std::vector<std::string> values;
+    ASSERT_EQ(
+        sqlw::status::Condition::DONE,
+        stmt(sql, [&](sqlw::Statement::ExecArgs e) {
+            values.emplace_back(e.column_value);
+        }));
+    ASSERT_EQ(
+        (std::vector<std::string>{
+            "4294967296",
+            "0.333333",
+            "-2.5e-10",
+            "text",
+            ""}),
+        values);
+
+    std::pmr::monotonic_buffer_resource arena;
+    stmt.prepare(sql).exec();
+    ASSERT_EQ(sqlw::status::Condition::ROW, stmt.status());
+
+    const auto value = stmt.column_value(sqlw::Type::SQL_DOUBLE, 1, &arena);
+    ASSERT_EQ("0.333333", value);
+    ASSERT_EQ(&arena, value.get_allocator().resource());
+    ASSERT_EQ("4294967296", stmt.column_value(sqlw::Type::SQL_INT, 0));
+}
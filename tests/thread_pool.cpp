@@ -0,0 +1,65 @@
+#include "sqlw/thread_pool.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+TEST(ThreadPool, runs_all_tasks)
+{
+    sqlw::ThreadPool pool{4};
+    std::atomic<int> sum{0};
+
+    for (int i = 1; i <= 1000; i++)
+    {
+        pool.submit([&, i](size_t worker) {
+            ASSERT_LT(worker, 4);
+            sum += i;
+        });
+    }
+
+    pool.wait();
+    ASSERT_EQ(500500, sum.load());
+}
+
+TEST(ThreadPool, steals_from_busy_workers)
+{
+    sqlw::ThreadPool pool{4};
+    std::array<std::atomic<int>, 4> ran_by{};
+
+    // All subtasks are queued by one worker; the others have to steal them.
+    pool.submit([&](size_t) {
+        for (int i = 0; i < 64; i++)
+        {
+            pool.submit([&](size_t worker) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                ran_by[worker]++;
+            });
+        }
+    });
+
+    pool.wait();
+
+    int total = 0;
+    int workers = 0;
+
+    for (const auto& n : ran_by)
+    {
+        total += n;
+        workers += n > 0 ? 1 : 0;
+    }
+
+    ASSERT_EQ(64, total);
+    ASSERT_GT(workers, 1);
+}
+
+TEST(ThreadPool, rethrows_task_exceptions)
+{
+    sqlw::ThreadPool pool{2};
+
+    pool.submit([](size_t) { throw std::runtime_error{"boom"}; });
+
+    ASSERT_THROW(pool.wait(), std::runtime_error);
+    ASSERT_NO_THROW(pool.wait());
+}